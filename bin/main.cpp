@@ -15,11 +15,13 @@ int main(int argc, char** argv) {
 
     ArgumentParser::ArgParser parser("Program");
     parser.AddIntArgument("N").MultiValue(1).Positional().StoreValues(values);
-    parser.AddFlag("sum", "add args").StoreValue(opt.sum);
-    parser.AddFlag("mult", "multiply args").StoreValue(opt.mult);
+    parser.AddFlag("sum", "add args");
+    parser.AddFlag("mult", "multiply args");
     parser.AddHelp('h', "help", "Program accumulate arguments");
+    parser.MutuallyExclusive({"sum", "mult"});
+    parser.Bind(&Options::sum, "sum").Bind(&Options::mult, "mult");
 
-    if(!parser.Parse(argc, argv)) {
+    if(!parser.ParseInto(opt, argc, argv)) {
         std::cout << "Wrong argument" << std::endl;
         std::cout << parser.HelpDescription() << std::endl;
         return 1;
@@ -0,0 +1,85 @@
+#include "ArgLexer.h"
+
+#include <vector>
+
+namespace ArgumentParser
+{
+
+void ArgLexer::Build(const std::deque<CommandLineOption>& options)
+{
+    std::vector<std::pair<std::string_view, uint32_t>> names;
+    names.reserve(options.size());
+    short_names.fill(OptionTrie::NoOption);
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+        const auto id = static_cast<uint32_t>(i);
+        names.emplace_back(options[i].GetLongOption(), id);
+        auto& shortName = short_names[static_cast<unsigned char>(options[i].GetShortOption())];
+        if (options[i].GetShortOption() && shortName == OptionTrie::NoOption) // при повторах - первая опция
+            shortName = id;
+    }
+    long_names.Build(std::move(names));
+    option_count = options.size();
+}
+
+ArgToken ArgLexer::Next(std::string_view arg, bool allowAbbreviations) const
+{
+    ArgToken token;
+    if (arg.empty()) // аргумент не должен быть пустой
+    {
+        token.error = "Empty argument";
+        return token;
+    }
+    if (arg[0] != '-') // не опция - позиционный аргумент
+    {
+        token.kind = TokenKind::Positional;
+        token.value = arg;
+        return token;
+    }
+
+    size_t pos = 1;
+    if (arg.size() > 1 && arg[1] == '-') // длинная опция: идем по автомату имен до '=' или конца
+    {
+        token.kind = TokenKind::LongOption;
+        uint32_t node = long_names.Root();
+        for (pos = 2; pos < arg.size() && arg[pos] != '='; ++pos)
+        {
+            if (node != OptionTrie::NoNode) // вышли из автомата - имя неизвестно, ищем только '='
+                node = long_names.Step(node, arg[pos]);
+        }
+        token.name = arg.substr(2, pos - 2);
+        if (node != OptionTrie::NoNode && !token.name.empty())
+        {
+            token.option = long_names.Exact(node);
+            if (token.option == OptionTrie::NoOption && allowAbbreviations)
+                token.option = long_names.Unique(node);
+        }
+    }
+    else // короткие опции
+    {
+        token.kind = TokenKind::ShortOptions;
+        while (pos < arg.size() && arg[pos] != '=')
+            ++pos;
+        token.name = arg.substr(1, pos - 1);
+    }
+
+    if (token.name.empty()) // после тире должно быть имя
+    {
+        token.kind = TokenKind::Invalid;
+        token.error = "Option name expected";
+        return token;
+    }
+    if (pos < arg.size()) // есть '=' - остаток аргумента значение
+    {
+        token.has_value = true;
+        token.value = arg.substr(pos + 1);
+        if (token.value.empty()) // '=' не может быть последним символом
+        {
+            token.kind = TokenKind::Invalid;
+            token.error = "Value expected after '='";
+        }
+    }
+    return token;
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+#include "CommandLineOption.h"
+#include "OptionTrie.h"
+
+namespace ArgumentParser
+{
+
+// Класс перечисления вида аргумента
+enum class TokenKind
+{
+    LongOption,     // --<имя>[=<значение>]
+    ShortOptions,   // -<короткие имена>[=<значение>]
+    Positional,     // не начинается с '-'
+    Invalid         // некорректный аргумент
+};
+
+// Результат разбора одного аргумента. Имя и значение - представления внутри самого аргумента.
+struct ArgToken
+{
+    TokenKind kind = TokenKind::Invalid;        // вид аргумента
+    uint32_t option = OptionTrie::NoOption;     // номер длинной опции (NoOption/Ambiguous, если не найдена)
+    std::string_view name;                      // имя длинной опции или короткие имена
+    std::string_view value;                     // значение после '=' (или весь позиционный аргумент)
+    bool has_value = false;                     // есть ли '='
+    const char* error = nullptr;                // причина некорректности (для Invalid)
+};
+
+// Лексический анализатор аргументов.
+// Имена зарегистрированных опций один раз компилируются в автомат (префиксное дерево длинных имен
+// и таблицу коротких), после чего каждый аргумент классифицируется и сопоставляется с опцией
+// за один проход слева направо, без поиска '=' заранее и без построения промежуточных строк.
+class ArgLexer
+{
+public:
+    ArgLexer() { short_names.fill(OptionTrie::NoOption); }
+
+    // Построить автомат по опциям
+    void Build(const std::deque<CommandLineOption>& options);
+
+    // Количество опций, по которым построен автомат
+    size_t Size() const { return option_count; }
+
+    // Разобрать аргумент arg; при allowAbbreviations длинное имя может быть однозначным сокращением
+    ArgToken Next(std::string_view arg, bool allowAbbreviations) const;
+
+    // Номер опции с коротким именем c (NoOption, если такой нет)
+    uint32_t ShortOption(char c) const { return short_names[static_cast<unsigned char>(c)]; }
+
+private:
+    OptionTrie long_names;                      // автомат длинных имен
+    std::array<uint32_t, 256> short_names{};    // короткое имя -> номер опции
+    size_t option_count = 0;                    // количество опций
+};
+
+}
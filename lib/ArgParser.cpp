@@ -1,7 +1,18 @@
 #include "ArgParser.h"
+#include "CommandLineTokenizer.h"
+#include "Environment.h"
+#include "Glob.h"
+#include "SimdScan.h"
+#include "ParseError.h"
+#include "Units.h"
+#include "ValueConverter.h"
 
 #include <utility>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <future>
+#include <iterator>
 #include <sstream>
 
 
@@ -30,8 +41,7 @@ CommandLineOption& ArgParser::AddIntArgument(std::string longOpt, std::string de
 CommandLineOption& ArgParser::AddIntArgument(char shortOpt, std::string longOpt, std::string desc)
 {
     // добавляем новую опцию для целочисленных значений
-    options.emplace_back(OptionType::IntegerOption, shortOpt, std::move(longOpt), std::move(desc));
-    return options.back(); // возвращаем ссылку на добавленную опцию
+    return AddOption(OptionType::IntegerOption, shortOpt, std::move(longOpt), std::move(desc)); // возвращаем ссылку на добавленную опцию
 }
 
 // аналогично со строковыми опциями
@@ -53,8 +63,7 @@ CommandLineOption& ArgParser::AddStringArgument(std::string longOpt, std::string
 
 CommandLineOption& ArgParser::AddStringArgument(char shortOpt, std::string longOpt, std::string desc)
 {
-    options.emplace_back(OptionType::StringOption, shortOpt, std::move(longOpt), std::move(desc));
-    return options.back();
+    return AddOption(OptionType::StringOption, shortOpt, std::move(longOpt), std::move(desc));
 }
 
 // аналогично с опциями-флагами
@@ -76,103 +85,1156 @@ CommandLineOption& ArgParser::AddFlag(std::string longOpt, std::string desc)
 
 CommandLineOption& ArgParser::AddFlag(char shortOpt, std::string longOpt, std::string desc)
 {
-    options.emplace_back(OptionType::FlagOption, shortOpt, std::move(longOpt), std::move(desc));
-    return options.back();
+    return AddOption(OptionType::FlagOption, shortOpt, std::move(longOpt), std::move(desc));
+}
+
+// аналогично с вещественными опциями, размерами и длительностями
+
+CommandLineOption& ArgParser::AddDoubleArgument(std::string longOpt)
+{
+    return AddDoubleArgument({}, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddDoubleArgument(char shortOpt, std::string longOpt)
+{
+    return AddDoubleArgument(shortOpt, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddDoubleArgument(std::string longOpt, std::string desc)
+{
+    return AddDoubleArgument({}, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddDoubleArgument(char shortOpt, std::string longOpt, std::string desc)
+{
+    return AddOption(OptionType::DoubleOption, shortOpt, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddSizeArgument(std::string longOpt)
+{
+    return AddSizeArgument({}, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddSizeArgument(char shortOpt, std::string longOpt)
+{
+    return AddSizeArgument(shortOpt, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddSizeArgument(std::string longOpt, std::string desc)
+{
+    return AddSizeArgument({}, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddSizeArgument(char shortOpt, std::string longOpt, std::string desc)
+{
+    return AddOption(OptionType::SizeOption, shortOpt, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddDurationArgument(std::string longOpt)
+{
+    return AddDurationArgument({}, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddDurationArgument(char shortOpt, std::string longOpt)
+{
+    return AddDurationArgument(shortOpt, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddDurationArgument(std::string longOpt, std::string desc)
+{
+    return AddDurationArgument({}, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddDurationArgument(char shortOpt, std::string longOpt, std::string desc)
+{
+    return AddOption(OptionType::DurationOption, shortOpt, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddPathArgument(std::string longOpt)
+{
+    return AddPathArgument({}, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddPathArgument(char shortOpt, std::string longOpt)
+{
+    return AddPathArgument(shortOpt, std::move(longOpt), {});
+}
+
+CommandLineOption& ArgParser::AddPathArgument(std::string longOpt, std::string desc)
+{
+    return AddPathArgument({}, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddPathArgument(char shortOpt, std::string longOpt, std::string desc)
+{
+    return AddOption(OptionType::PathOption, shortOpt, std::move(longOpt), std::move(desc));
 }
 
 // и опцией-справкой
 CommandLineOption& ArgParser::AddHelp(char shortOpt, std::string longOpt, std::string desc)
 {
-    options.emplace_back(OptionType::HelpOption, shortOpt, std::move(longOpt), std::move(desc));
-    return options.back();
+    return AddOption(OptionType::HelpOption, shortOpt, std::move(longOpt), std::move(desc));
+}
+
+CommandLineOption& ArgParser::AddOption(OptionType type, char shortOpt, std::string longOpt, std::string desc)
+{
+    if (frozen) // набор опций зафиксирован
+        throw std::logic_error("Parser is frozen");
+    auto& opt = options.emplace_back(type, shortOpt, std::move(longOpt), std::move(desc));
+    // ключ - представление имени, хранящегося в самой опции (deque не перемещает элементы)
+    option_index.emplace(opt.GetLongOption(), options.size() - 1);
+    return opt;
+}
+
+ArgParser& ArgParser::AddSubcommand(std::string name, SubcommandFactory factory)
+{
+    return AddSubcommand(std::move(name), {}, std::move(factory)); // без описания
+}
+
+ArgParser& ArgParser::AddSubcommand(std::string name, std::string desc, SubcommandFactory factory)
+{
+    if (frozen)
+        throw std::logic_error("Parser is frozen");
+    subcommands.push_back({std::move(name), std::move(desc), std::move(factory)}); // только запоминаем фабрику
+    return *this;
+}
+
+ArgParser& ArgParser::OnUnknownOption(UnknownOptionHandler handler)
+{
+    unknown_option_handler = std::move(handler);
+    return *this;
+}
+
+ArgParser& ArgParser::AllowAbbreviations(bool allow)
+{
+    allow_abbreviations = allow;
+    return *this;
+}
+
+ArgParser& ArgParser::AllowResponseFiles(bool allow)
+{
+    allow_response_files = allow;
+    return *this;
+}
+
+ArgParser& ArgParser::ParallelResponseFiles(size_t minShardBytes)
+{
+    if (minShardBytes == 0)
+        throw std::logic_error("Shard size can not be zero");
+    response_shard_bytes = minShardBytes;
+    return *this;
+}
+
+ArgParser& ArgParser::MutuallyExclusive(const std::vector<std::string>& names)
+{
+    constraints.push_back({Constraint::Kind::MutuallyExclusive, 0, OptionSet(names)});
+    return *this;
+}
+
+ArgParser& ArgParser::AtLeastOneOf(const std::vector<std::string>& names)
+{
+    constraints.push_back({Constraint::Kind::AtLeastOneOf, 0, OptionSet(names)});
+    return *this;
+}
+
+ArgParser& ArgParser::Requires(const std::string& longOpt, const std::vector<std::string>& names)
+{
+    const auto it = option_index.find(longOpt);
+    if (it == option_index.end())
+        throw std::logic_error("No option named " + longOpt);
+    constraints.push_back({Constraint::Kind::Requires, it->second, OptionSet(names)});
+    return *this;
+}
+
+OptionBitset ArgParser::OptionSet(const std::vector<std::string>& names) const
+{
+    if (frozen) // ограничения влияют на результаты, уже сохраненные в кэше
+        throw std::logic_error("Parser is frozen");
+    OptionBitset set(options.size());
+    for (const auto& name: names)
+    {
+        const auto it = option_index.find(name);
+        if (it == option_index.end())
+            throw std::logic_error("No option named " + name);
+        set.Set(it->second);
+    }
+    return set;
+}
+
+bool ArgParser::LoadConfig(const std::string& path)
+{
+    if (frozen) // конфигурация влияет на результаты, уже сохраненные в кэше
+        throw std::logic_error("Parser is frozen");
+    try
+    {
+        config_files.emplace_back(path);
+    }
+    catch (std::exception&)
+    {
+        return false; // файл недоступен
+    }
+    // разбираем строки прямо в отображенном файле, значения - представления без копирования;
+    // в конфигурацию они попадают, только если корректен весь файл
+    std::vector<std::vector<std::string_view>> values(options.size());
+    const auto reject = [this]() {
+        config_files.pop_back();
+        return false;
+    };
+    auto text = config_files.back().View();
+    while (!text.empty())
+    {
+        auto eol = text.find('\n');
+        auto line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+        const auto trim = [](std::string_view str) { // убираем пробельные символы по краям
+            const auto first = str.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos)
+                return std::string_view{};
+            return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+        };
+
+        line = trim(line);
+        if (line.empty() || line[0] == '#') // пустая строка или комментарий
+            continue;
+
+        const auto eq_pos = line.find('=');
+        const auto key = trim(line.substr(0, eq_pos));
+        const auto it = option_index.find(key);
+        if (it == option_index.end()) // неизвестная опция
+            return reject();
+
+        // строка без '=' допустима только для флага и означает, что он установлен
+        if (eq_pos == std::string_view::npos && options[it->second].GetType() != OptionType::FlagOption)
+            return reject();
+        values[it->second].push_back(eq_pos == std::string_view::npos ? "1" : trim(line.substr(eq_pos + 1)));
+    }
+
+    config_values.resize(options.size());
+    for (size_t id = 0; id < values.size(); ++id)
+        config_values[id].insert(config_values[id].end(), values[id].begin(), values[id].end());
+    return true;
+}
+
+ArgParser& ArgParser::Freeze()
+{
+    if (frozen)
+        return *this;
+    frozen = true;
+    BuildLexer();
+    auto index = std::make_shared<ParseResult::NameIndex>();
+    for (const auto& [name, id]: option_index) // у результатов свой индекс: они могут пережить парсер
+        index->emplace(name, id);
+    frozen_index = std::move(index);
+    return *this;
+}
+
+ArgParser& ArgParser::EnableCache(size_t capacity)
+{
+    Freeze();
+    cache.SetCapacity(capacity);
+    return *this;
+}
+
+std::shared_ptr<const ParseResult> ArgParser::ParseCached(const std::vector<std::string>& args)
+{
+    Freeze();
+    const auto hash = ParseCache::Hash(args);
+    if (auto cached = cache.Find(hash, args)) // тот же список уже разбирался
+        return cached;
+
+    auto result = ParseToResult(args);
+    cache.Insert(hash, args, result);
+    return result;
+}
+
+std::shared_ptr<const ParseResult> ArgParser::ParseToResult(const std::vector<std::string>& args)
+{
+    for (auto& opt: options) // разбор с чистого листа
+        opt.ClearValues();
+    record_sources = true;
+    ParseTokens(std::vector<std::string_view>(args.begin(), args.end()));
+    record_sources = false;
+
+    auto result = std::const_pointer_cast<ParseResult>(Snapshot());
+    result->args = std::make_shared<const std::vector<std::string>>(args);
+    result->positional_start = positional_start;
+    result->sources = std::move(option_sources);
+    result->seen = seen;
+    // по частям разбираются только результаты, где разобраны все аргументы,
+    // а ошибки - лишь нехватка значений и нарушения ограничений групп; пути без полного разбора не проверяются
+    result->incremental = !stopped_early && subcommands.empty() && !allow_response_files && path_checked.Count() == 0 &&
+        std::all_of(errors.begin(), errors.end(), [](const auto& error){
+            return error.code == ParseErrorCode::MissingValue || error.code == ParseErrorCode::ConstraintViolation;
+        });
+    return result;
+}
+
+std::shared_ptr<const ParseResult> ArgParser::Reparse(const ParseResult& previous, const ArgEdit& edit)
+{
+    Freeze();
+    if (previous.index != frozen_index || !previous.args) // результат другого парсера или не из ParseCached
+        throw std::logic_error("Result was not produced by this parser");
+
+    auto args = *previous.args;
+    const bool insert = edit.kind == ArgEdit::Kind::Insert;
+    if (edit.index == 0 || edit.index > args.size() || (!insert && edit.index == args.size()))
+        throw std::out_of_range("Edit position out of range");
+
+    if (previous.incremental)
+    {
+        try
+        {
+            if (auto result = ReparseIncrementally(previous, edit, args))
+                return result;
+        }
+        catch (ParseException&)
+        {
+            // ошибка в новом аргументе - полный разбор сформирует ее как обычно
+        }
+    }
+
+    if (edit.kind == ArgEdit::Kind::Replace)
+        args[edit.index] = edit.value;
+    else if (insert)
+        args.insert(args.begin() + static_cast<std::ptrdiff_t>(edit.index), edit.value);
+    else
+        args.erase(args.begin() + static_cast<std::ptrdiff_t>(edit.index));
+    return ParseToResult(args);
+}
+
+// Аргументы делятся на две части: опции до первого позиционного аргумента (positional_start) и позиционные после.
+// Правка внутри одной части затрагивает только опции этой части: для опций пересобираются значения из
+// записанных в sources аргументов, а у позиционных значение заменяется, вставляется или удаляется на месте.
+// Правка, переносящая аргумент из одной части в другую, требует полного разбора.
+std::shared_ptr<const ParseResult> ArgParser::ReparseIncrementally(const ParseResult& previous, const ArgEdit& edit,
+                                                                   std::vector<std::string> args)
+{
+    const auto index = edit.index;
+    const auto start = previous.positional_start;
+    const bool isOption = edit.kind != ArgEdit::Kind::Erase && !edit.value.empty() && edit.value[0] == '-';
+
+    const auto newOptions = std::make_shared<ParseResult>(previous);
+    std::vector<uint32_t> dirty; // опции, значения которых нужно пересобрать
+
+    // правка среди опций: до первого позиционного, либо вставка опции прямо перед ним
+    const bool optionPart = index < start || (edit.kind == ArgEdit::Kind::Insert && index == start && isOption);
+    if (optionPart)
+    {
+        if (edit.kind != ArgEdit::Kind::Erase && !isOption) // позиционный аргумент среди опций меняет разбиение
+            return nullptr;
+
+        const auto collect = [this, &dirty](std::string_view arg) { // опции аргумента; false - справка
+            const auto token = lexer.Next(arg, allow_abbreviations);
+            if (token.kind == TokenKind::Invalid || token.kind == TokenKind::Positional)
+                return false;
+            return !ForEachOptionValue(token, [this, &dirty](uint32_t id, const std::string_view*){
+                dirty.push_back(id);
+                return options[id].GetType() == OptionType::HelpOption;
+            });
+        };
+
+        auto& sources = newOptions->sources;
+        const auto removeIndex = [index](std::vector<uint32_t>& list) {
+            list.erase(std::remove(list.begin(), list.end(), index), list.end());
+        };
+        if (edit.kind != ArgEdit::Kind::Insert) // прежний аргумент больше не задает значений
+        {
+            if (!collect(previous.args->at(index)))
+                return nullptr;
+            for (const auto id: dirty)
+                removeIndex(sources[id]);
+        }
+        if (edit.kind != ArgEdit::Kind::Replace) // номера последующих аргументов сдвигаются
+        {
+            for (auto& list: sources)
+            {
+                for (auto& source: list)
+                {
+                    if (source >= index)
+                        source += edit.kind == ArgEdit::Kind::Insert ? 1 : -1;
+                }
+            }
+        }
+        if (edit.kind != ArgEdit::Kind::Erase) // новый аргумент задает значения своих опций
+        {
+            const auto before = dirty.size();
+            if (!collect(edit.value))
+                return nullptr;
+            for (auto it = dirty.begin() + static_cast<std::ptrdiff_t>(before); it != dirty.end(); ++it)
+            {
+                auto& list = sources[*it];
+                const auto pos = std::lower_bound(list.begin(), list.end(), static_cast<uint32_t>(index));
+                if (pos == list.end() || *pos != index)
+                    list.insert(pos, static_cast<uint32_t>(index));
+            }
+        }
+
+        if (edit.kind == ArgEdit::Kind::Replace)
+            args[index] = edit.value;
+        else if (edit.kind == ArgEdit::Kind::Insert)
+            args.insert(args.begin() + static_cast<std::ptrdiff_t>(index), edit.value);
+        else
+            args.erase(args.begin() + static_cast<std::ptrdiff_t>(index));
+        newOptions->positional_start = edit.kind == ArgEdit::Kind::Replace ? start
+            : edit.kind == ArgEdit::Kind::Insert ? start + 1 : start - 1;
+
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+        if (std::any_of(dirty.begin(), dirty.end(), [this](uint32_t id){ return options[id].GetGlobLimit() != 0; }))
+            return nullptr; // шаблоны разворачивает только полный разбор
+        for (const auto id: dirty) // пересобираем значения затронутых опций из их аргументов
+        {
+            auto opt = std::make_shared<CommandLineOption>(*previous.options[id]);
+            opt->ClearValues();
+            for (const auto source: sources[id])
+            {
+                ForEachOptionValue(lexer.Next(args[source], allow_abbreviations),
+                                   [&opt, id](uint32_t optionId, const std::string_view* value){
+                    if (optionId == id)
+                        value ? SetValueOption(*opt, *value) : SetFlagOption(*opt);
+                    return false;
+                });
+            }
+            if (opt->GetValuesCount() == 0) // в аргументах опции нет
+                ApplyFallback(id, *opt);
+            newOptions->options[id] = std::move(opt);
+        }
+    }
+    else // правка среди позиционных аргументов
+    {
+        // первым позиционным должен остаться аргумент без '-'
+        if (index == start && (isOption || (edit.kind == ArgEdit::Kind::Erase && index + 1 < args.size() &&
+                                            !args[index + 1].empty() && args[index + 1][0] == '-')))
+            return nullptr;
+
+        const auto it = std::find_if(options.begin(), options.end(), [](const auto& opt){
+            return opt.IsPositional();
+        });
+        if (it == options.end()) // позиционных опций нет - полный разбор сообщит об ошибке
+            return nullptr;
+        const auto id = static_cast<uint32_t>(it - options.begin());
+        auto opt = std::make_shared<CommandLineOption>(*previous.options[id]);
+        // значения в файле, отрезки и пользовательские значения на месте не правятся;
+        // с разделителем аргумент - не одно значение
+        if (opt->SpillsToDisk() || opt->UsesRanges() || opt->GetSeparator() || opt->GetGlobLimit() ||
+            opt->GetType() == OptionType::CustomOption)
+            return nullptr;
+
+        const auto pos = index - start;
+        if (edit.kind == ArgEdit::Kind::Replace)
+            args[index] = edit.value;
+        else if (edit.kind == ArgEdit::Kind::Insert)
+            args.insert(args.begin() + static_cast<std::ptrdiff_t>(index), edit.value);
+        else
+            args.erase(args.begin() + static_cast<std::ptrdiff_t>(index));
+
+        if (opt->IsMultiValue()) // значение правится на месте, остальные не преобразуются заново
+        {
+            if (edit.kind != ArgEdit::Kind::Insert)
+                opt->EraseValue(pos);
+            if (edit.kind != ArgEdit::Kind::Erase)
+            {
+                SetValueOption(*opt, edit.value);
+                opt->MoveLastValue(pos);
+            }
+        }
+        else // одиночное значение - последнее из позиционных
+        {
+            opt->ClearValues();
+            if (start < args.size())
+                SetValueOption(*opt, args.back());
+        }
+        if (opt->GetValuesCount() == 0)
+            ApplyFallback(id, *opt);
+        newOptions->options[id] = std::move(opt);
+        dirty.push_back(id);
+    }
+
+    // проверяем только затронутые опции; ошибки остальных переходят из previous
+    auto& newErrors = newOptions->errors;
+    newErrors.erase(std::remove_if(newErrors.begin(), newErrors.end(), [this, &dirty](const auto& error){
+        return error.code == ParseErrorCode::ConstraintViolation || // ограничения групп проверяются заново
+            std::binary_search(dirty.begin(), dirty.end(), option_index.at(error.option));
+    }), newErrors.end());
+    for (const auto id: dirty)
+    {
+        const auto& opt = *newOptions->options[id];
+        if (opt.GetType() == OptionType::FlagOption) // пересобранный флаг хранит значение в самой опции
+        {
+            if (opt.GetFlag())
+                newOptions->flags.Set(id);
+            else
+                newOptions->flags.Reset(id);
+        }
+        if (opt.GetValuesCount() != 0)
+            newOptions->seen.Set(id);
+        else
+            newOptions->seen.Reset(id);
+        if (!opt.IsValid())
+        {
+            const auto& name = options[id].GetLongOption();
+            newErrors.push_back({ParseErrorCode::MissingValue, name, "No value for option " + name, {}});
+        }
+    }
+    std::sort(newErrors.begin(), newErrors.end(), [this](const auto& lhs, const auto& rhs){ // в порядке опций
+        return option_index.at(lhs.option) < option_index.at(rhs.option);
+    });
+    CheckConstraints(newOptions->seen, newErrors);
+
+    newOptions->args = std::make_shared<const std::vector<std::string>>(std::move(args));
+    return newOptions;
+}
+
+std::shared_ptr<const ParseResult> ArgParser::Snapshot() const
+{
+    std::vector<std::shared_ptr<const CommandLineOption>> snapshot;
+    snapshot.reserve(options.size());
+    for (const auto& opt: options)
+    {
+        auto copy = std::make_shared<CommandLineOption>(opt);
+        copy->DetachExternalStorage(); // снимок не пишет в переменные программы
+        snapshot.push_back(std::move(copy));
+    }
+    auto result = std::make_shared<ParseResult>(frozen_index, std::move(snapshot), errors);
+    result->flags = flag_values; // значения флагов - в битовом множестве, а не в опциях
+    return result;
 }
 
 bool ArgParser::Parse(int argc, char** argv)
-{ // используем перегруженный метод
-    return Parse(std::vector<std::string>(argv, argv + argc));
+{ // аргументы читаются прямо из памяти argv, без копирования в строки
+    return ParseTokens(std::vector<std::string_view>(argv, argv + argc));
 }
 
 bool ArgParser::Parse(const std::vector<std::string>& args)
 {
-    if (args.empty()) // нет аргументов (должен быть как минимум один - имя файла самой программы)
+    return ParseTokens(std::vector<std::string_view>(args.begin(), args.end()));
+}
+
+bool ArgParser::ParseCommandLine(std::string_view commandLine)
+{
+    CommandLineTokenizer tokenizer; // хранит экранированные аргументы до конца разбора
+    std::vector<std::string_view> args;
+    if (!tokenizer.Split(commandLine, args))
+    {
+        errors.clear();
+        return AddError({ParseErrorCode::InvalidArgument, std::string(commandLine), "Unterminated quote"});
+    }
+    return ParseTokens(std::move(args));
+}
+
+template<typename F>
+bool ArgParser::ForEachOptionValue(const ArgToken& token, F&& apply)
+{
+    if (token.kind == TokenKind::LongOption) // длинная опция (начинается с "--")
+        return apply(GetLongOptionId(token), token.has_value ? &token.value : nullptr);
+
+    // иначе, короткая опция (опции)
+    // сколько из них - флаги, например,
+    // -ас - два флага (а и с)
+    // -асх=1 - два флага и целочисленное значение 1 для опции х
+    const auto flagCount = token.has_value ? token.name.size() - 1 : token.name.size();
+    for (size_t j = 0; j < flagCount; ++j) // перебираем флаги
+    {
+        if (apply(GetShortOptionId(token.name[j]), nullptr))
+            return true;
+    }
+    // если кроме флагов, была другая опция (как х в примере выше) (возможна только одна)
+    return token.has_value && apply(GetShortOptionId(token.name.back()), &token.value);
+}
+
+bool ArgParser::HasUnknownOption(const ArgToken& token) const
+{
+    if (token.kind == TokenKind::LongOption)
+        return token.option == OptionTrie::NoOption;
+    if (token.kind != TokenKind::ShortOptions)
         return false;
+    return std::any_of(token.name.begin(), token.name.end(), [this](char c){
+        return lexer.ShortOption(c) == OptionTrie::NoOption;
+    });
+}
+
+bool ArgParser::ParseTokens(std::vector<std::string_view> args)
+{
+    errors.clear();
+    if (args.empty()) // нет аргументов (должен быть как минимум один - имя файла самой программы)
+        return AddError({ParseErrorCode::InvalidArgument, {}, "No program name"});
 
+    StartParse();
     try
     {
+        if (allow_response_files)
+            ExpandResponseFiles(args);
+        positional_start = args.size();
+
         // проход по аргументам (пропускаем первый - название программы)
         for (size_t argIndex = 1; argIndex < args.size(); ++argIndex)
         {
-            const auto& arg = args[argIndex]; // текущий аргумент
-            if (arg.empty()) // аргумент не должен быть пустой
-                return false;
+            const auto arg = args[argIndex]; // текущий аргумент
+            // вид аргумента, опция, имя и значение определяются за один проход по нему
+            // (аргументы больших файлов - заранее, параллельно по сегментам)
+            const auto token = argIndex < prepared.size() && prepared[argIndex].lexed
+                ? prepared[argIndex].token : lexer.Next(arg, allow_abbreviations);
 
-            if (arg[0] == '-') // начало опции
-            {
-                if (arg.size() < 2) // некорректная опция
-                    return false;
+            if (token.kind == TokenKind::Invalid) // некорректный аргумент
+                return AddError({ParseErrorCode::InvalidArgument, std::string(arg), token.error});
 
-                auto eq_pos = arg.find('='); // позиция символа '=' в текущем аргументе
-                if (eq_pos == std::string::npos) // если '=' не найден
-                    eq_pos = arg.size(); // установим на конец текущей опции
+            if (unknown_option_handler && HasUnknownOption(token) && unknown_option_handler(arg))
+                continue; // аргумент обработан программой
 
-                if (eq_pos == arg.size() - 1) // если '=' - последний символ опции
-                    return false; // то, опция некорректна
+            if (token.kind == TokenKind::ShortOptions && !token.has_value && !record_sources &&
+                SetShortFlags(token.name)) // кластер флагов (-abc) устанавливается масками, без перебора опций
+                continue;
 
-                if (arg[1] == '-') // длинная опция (начинается с "--")
-                {
-                    if (arg.size() < 3) // после тире должно быть что-то еще
+            if (token.kind != TokenKind::Positional) // опция (опции)
+            {
+                const bool help = ForEachOptionValue(token, [this, argIndex](uint32_t id, const std::string_view* value){
+                    auto& opt = options[id];
+                    seen.Set(id);
+                    if (record_sources && (option_sources[id].empty() || option_sources[id].back() != argIndex))
+                        option_sources[id].push_back(static_cast<uint32_t>(argIndex)); // для повторного разбора
+                    if (value) // есть '=' - устанавливаем для опции значение, указанное после '='
+                    {
+                        if (!UsePrepared(id, argIndex, *value))
+                            SetOptionValue(id, *value);
                         return false;
-
-                    const auto longOptName = arg.substr(2, eq_pos - 2); // имя опции (без "--" до '=')
-                    auto& opt = GetOption(longOptName); // получаем объект опции для указанного имени
-                    if (eq_pos == arg.size()) // если '=' отсутствует,
-                    { // значит текущая опция - флаг
-                        SetFlagOption(opt); // устанавливаем его значение (true, так как флаг указан)
-                        if (opt.GetType() == OptionType::HelpOption) // если был запрос на справку,
-                            return true; // успешно завершаем разбор аргументов (требуется только вывод справки)
                     }
-                    else // иначе (есть '=')
-                    { // устанавливаем для текущей опции значение, указанное после '='
-                        SetValueOption(opt, arg.substr(eq_pos + 1));
+                    if (opt.GetType() == OptionType::FlagOption) // иначе - флаг; он указан, значит true
+                    {
+                        flag_values.Set(id);
+                        if (IsBound(id)) // привязанный флаг - сразу в поле структуры
+                            WriteBound(id, "1");
+                        if (!flag_setters.Test(id) || IsBound(id)) // внешнего хранилища и действия нет - опцию не трогаем
+                            return false;
                     }
+                    SetFlagOption(opt); // флаг, справка (или ошибка, если опции нужно значение)
+                    return opt.GetType() == OptionType::HelpOption; // был ли запрос на справку
+                });
+                if (help) // если был запрос на справку,
+                {
+                    stopped_early = true;
+                    return true; // успешно завершаем разбор аргументов (требуется только вывод справки)
                 }
-                else // иначе, короткая опция (опции)
+            }
+            else // иначе, аргумент начинается не с '-', значит все последующие аргументы - позиционные
+            {    // либо это подкоманда, и все последующие аргументы относятся к ней
+                positional_start = argIndex;
+                const auto sub = std::find_if(subcommands.begin(), subcommands.end(), [&arg](const auto& cmd){
+                    return cmd.name == arg;
+                });
+                if (sub != subcommands.end())
                 {
-                    // сколько из них - флаги, например,
-                    // -ас - два флага (а и с)
-                    // -асх=1 - два флага и целочисленное значение 1 для опции х
-                    auto flagCount = eq_pos == arg.size() ? eq_pos : eq_pos - 2;
-                    for (size_t j = 1; j < flagCount; ++j) // перебираем флаги
+                    stopped_early = true;
+                    active_subcommand = &*sub;
+                    subcommand_parser = std::make_unique<ArgParser>(sub->name); // только теперь строим парсер
+                    sub->factory(*subcommand_parser);
+                    // имя подкоманды для нее - то же, что имя программы
+                    if (!subcommand_parser->ParseTokens({args.begin() + argIndex, args.end()}))
                     {
-                        const auto shortOptName = arg[j]; // короткое имя текущего флага
-                        auto& opt = GetOption(shortOptName); // получаем опцию по этому имени
-                        SetFlagOption(opt); // устанавливаем флаг
-                        if (opt.GetType() == OptionType::HelpOption) // если был запрос на справку,
-                            return true; // успешно завершаем разбор аргументов (требуется только вывод справки)
+                        errors = subcommand_parser->GetErrors(); // ошибки подкоманды - ошибки разбора
+                        return false;
                     }
+                    break;
+                }
 
-                    if (flagCount != eq_pos) // если кроме флагов, была другая опция (как х в примере выше) (возможна только одна)
-                    {
-                        const auto shortOptName = arg[eq_pos - 1]; // короткое имя
-                        auto& opt = GetOption(shortOptName); // соответствующая опция
-                        SetValueOption(opt, arg.substr(eq_pos + 1)); // устанавливаем значение
-                    }
+                const auto positionalId = static_cast<uint32_t>(option_index.at(GetPositionalArgument().GetLongOption()));
+                seen.Set(positionalId); // опция для позиционных аргументов
+                for (; argIndex < args.size(); ++argIndex) // перебираем все оставшиеся аргументы
+                {
+                    if (!UsePrepared(positionalId, argIndex, args[argIndex]))
+                        SetOptionValue(positionalId, args[argIndex]); // добавляем значения
                 }
             }
-            else // иначе, аргумент начинается не с '-', значит все последующие аргументы - позиционные
+        }
+        ApplyFallbacks(); // не указанные опции берем из окружения или конфигурации
+        std::vector<PreparedArg>().swap(prepared); // подготовленные аргументы больше не нужны
+    }
+    catch (ParseException& e)
+    {
+        return AddError(e.GetError()); // произошла ошибка - опции некорректны
+    }
+    catch (std::exception& e)
+    {
+        return AddError({ParseErrorCode::InvalidArgument, {}, e.what()});
+    }
+    return FinishParse();
+}
+
+void ArgParser::StartParse()
+{
+    if (lexer.Size() != options.size()) // автомат имен строится один раз после добавления всех опций
+        BuildLexer();
+    // значения из окружения и конфигурации прошлого разбора берутся заново
+    from_fallback.ForEach([this](size_t id) { options[id].ClearValues(); });
+    from_fallback = OptionBitset(options.size());
+    // маски - заново при каждом разборе: значения по умолчанию, MultiValue и хранилища могут измениться между разборами
+    BuildMasks();
+    stopped_early = false;
+    active_subcommand = nullptr; // подкоманда прошлого разбора
+    subcommand_parser.reset();
+    prepared.clear();
+    response_files.clear(); // значения прошлого разбора уже скопированы - отображения не нужны
+    compressed_files.clear();
+    {
+        std::vector<ParseError> stale; // проверки прерванного разбора больше не нужны
+        path_checker.Collect(stale, prefetched);
+    }
+    prefetched.clear(); // файлы прошлого разбора закрываются
+    flag_values = flag_defaults;
+    if (record_sources)
+        option_sources.assign(options.size(), {});
+}
+
+bool ArgParser::FinishParse()
+{
+    path_checker.Collect(errors, prefetched); // пути проверялись в фоне, пока разбирались аргументы
+    for (size_t id = 0; id < prefetched.size(); ++id)
+    {
+        auto& files = prefetched[id];
+        if (files.size() > 1 && !options[id].IsMultiValue()) // одиночная опция - файл последнего значения
+            files.erase(files.begin(), files.end() - 1);
+    }
+    // проверяем, что все опции корректны и ограничения групп выполнены, и возвращаем результат проверки
+    ValidateRequired();
+    CheckConstraints(seen, errors);
+    return errors.empty();
+}
+
+bool ArgParser::ParseBinary(const std::byte* data, size_t size)
+{
+    errors.clear();
+    StartParse();
+    positional_start = 0;
+    try
+    {
+        size_t pos = 0;
+        // очередные count байт данных
+        const auto take = [data, size, &pos](size_t count) {
+            if (size - pos < count)
+                throw ParseException({ParseErrorCode::InvalidArgument, {}, "Truncated binary arguments"});
+            pos += count;
+            return std::string_view(reinterpret_cast<const char*>(data + pos - count), count);
+        };
+        const auto takeU32 = [&take]() { return LoadLittleEndian<uint32_t>(reinterpret_cast<const std::byte*>(take(4).data())); };
+
+        if (take(std::min(size, BinaryArgsMagic.size())) != BinaryArgsMagic)
+            throw ParseException({ParseErrorCode::InvalidArgument, {}, "Not a binary argument list"});
+        while (pos < size)
+        {
+            auto id = takeU32();
+            if (id == BinaryNameKey) // опция по имени
             {
-                auto& opt = GetPositionalArgument(); // ищем опцию для позиционных аргументов
-                for (; argIndex < args.size(); ++argIndex) // перебираем все оставшиеся аргументы
-                    SetValueOption(opt, args[argIndex]); // добавляем значения
+                const auto name = take(takeU32());
+                const auto it = option_index.find(name);
+                if (it == option_index.end())
+                    throw UnknownOption(name);
+                id = static_cast<uint32_t>(it->second);
+            }
+            else if (id >= options.size())
+                throw ParseException({ParseErrorCode::UnknownOption, std::to_string(id),
+                                      "Unknown option number " + std::to_string(id)});
+            const auto value = take(takeU32());
+            seen.Set(id);
+            if (SetBinaryValue(id, value)) // запрос справки - как и в Parse, разбор на этом заканчивается
+            {
+                stopped_early = true;
+                return true;
             }
         }
+        ApplyFallbacks(); // не указанные опции берем из окружения или конфигурации
     }
-    catch (std::exception&)
+    catch (ParseException& e)
+    {
+        return AddError(e.GetError());
+    }
+    catch (std::exception& e)
     {
-        return false; // произошла ошибка - опции некорректны
+        return AddError({ParseErrorCode::InvalidArgument, {}, e.what()});
     }
-    // проверяем, что все опции корректны, и возвращаем результат проверки
-    return std::all_of(options.begin(), options.end(), [](const auto& opt) { return opt.IsValid(); });
+    return FinishParse();
+}
+
+bool ArgParser::SetBinaryValue(uint32_t id, std::string_view value)
+{
+    auto& opt = options[id];
+    const auto* bytes = reinterpret_cast<const std::byte*>(value.data());
+    const auto expect = [&opt, &value](size_t size) {
+        if (value.size() != size)
+            throw ParseException({ParseErrorCode::InvalidValue, opt.GetLongOption(),
+                                  "Wrong binary value size for option " + opt.GetLongOption()});
+    };
+    switch (opt.GetType())
+    {
+        case OptionType::HelpOption:
+            SetFlagOption(opt);
+            return true;
+        case OptionType::FlagOption:
+        {
+            expect(1);
+            const bool flag = value[0] != '\0';
+            if (flag)
+                flag_values.Set(id);
+            else
+                flag_values.Reset(id);
+            if (flag_setters.Test(id)) // внешнее хранилище или действие
+                opt.SetValue(flag);
+            break;
+        }
+        case OptionType::IntegerOption:
+        case OptionType::EnumOption:
+        {
+            expect(sizeof(int32_t));
+            const int number = LoadLittleEndian<int32_t>(bytes);
+            if (opt.GetType() == OptionType::EnumOption && opt.GetChoiceName(number).empty())
+                throw ParseException({ParseErrorCode::InvalidValue, opt.GetLongOption(),
+                                      "Wrong value " + std::to_string(number) + " for option " + opt.GetLongOption()});
+            opt.SetValue(number);
+            break;
+        }
+        case OptionType::DoubleOption:
+        {
+            expect(sizeof(double));
+            const auto bits = LoadLittleEndian<uint64_t>(bytes);
+            double number = 0;
+            std::memcpy(&number, &bits, sizeof(number));
+            opt.SetValue(number);
+            break;
+        }
+        case OptionType::SizeOption:
+            expect(sizeof(uint64_t));
+            opt.SetValue(LoadLittleEndian<uint64_t>(bytes));
+            break;
+        case OptionType::DurationOption:
+            expect(sizeof(int64_t));
+            opt.SetValue(std::chrono::nanoseconds(LoadLittleEndian<int64_t>(bytes)));
+            break;
+        case OptionType::StringOption:
+        case OptionType::PathOption:
+            if (opt.GetGlobLimit()) // шаблон разворачивается так же, как в тексте
+            {
+                SetOptionValue(id, value);
+                break;
+            }
+            opt.SetValue(std::string(value));
+            if (path_checked.Test(id)) // одна запись - один путь (без разделителя)
+                path_checker.Add(Workers(), id, opt.GetLongOption(), value, opt.GetPathChecks());
+            break;
+        default: // пользовательский тип - текст для преобразователя
+            SetSingleValue(opt, value);
+            break;
+    }
+    return false;
+}
+
+void ArgParser::BuildLexer()
+{
+    lexer.Build(options);
+}
+
+void ArgParser::BuildMasks()
+{
+    flag_defaults = OptionBitset(options.size());
+    flag_setters = OptionBitset(options.size());
+    short_flags.fill({});
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+        const auto& opt = options[i];
+        if (opt.GetType() != OptionType::FlagOption)
+            continue;
+        if (opt.GetDefaultFlag())
+            flag_defaults.Set(i);
+        if (opt.HasExternalStorage() || opt.HasAction() || (i < bindings.size() && bindings[i]))
+            flag_setters.Set(i); // такие флаги устанавливаются через опцию или таблицу привязок
+        else if (opt.GetShortOption())
+            short_flags[static_cast<unsigned char>(opt.GetShortOption())] = {static_cast<uint32_t>(i / 64),
+                                                                             uint64_t{1} << (i % 64)};
+    }
+    path_checked = OptionBitset(options.size());
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+        if (options[i].GetPathChecks())
+            path_checked.Set(i);
+    }
+    required = OptionBitset(options.size());
+    counted = OptionBitset(options.size());
+    seen = OptionBitset(options.size());
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+        const auto& opt = options[i];
+        if (opt.GetType() == OptionType::HelpOption)
+            continue;
+        if (opt.IsMultiValue() ? opt.GetMinArgs() > 0 : !opt.HasDefault())
+            required.Set(i);
+        if (opt.IsMultiValue() && opt.GetMinArgs() > 1)
+            counted.Set(i);
+    }
+}
+
+bool ArgParser::SetShortFlags(std::string_view names)
+{
+    for (const auto c: names) // ошибки и не флаги разбираются обычным путем
+    {
+        if (short_flags[static_cast<unsigned char>(c)].bit == 0)
+            return false;
+    }
+    for (const auto c: names)
+    {
+        const auto& mask = short_flags[static_cast<unsigned char>(c)];
+        flag_values.SetWord(mask.word, mask.bit);
+        seen.SetWord(mask.word, mask.bit);
+    }
+    return true;
+}
+
+void ArgParser::ValidateOption(const CommandLineOption& opt)
+{
+    if (!opt.IsValid())
+        AddError({ParseErrorCode::MissingValue, opt.GetLongOption(), "No value for option " + opt.GetLongOption()});
+}
+
+// Некорректной может быть только обязательная опция, которая не указана, либо указанная MultiValue опция,
+// которой нужно больше одного значения: check = required & ~(seen & ~counted). Остальные опции не перебираются.
+void ArgParser::ValidateRequired()
+{
+    auto satisfied = seen;
+    satisfied.AndNot(counted);
+    auto check = required;
+    check.AndNot(satisfied);
+    check.ForEach([this](size_t id){
+        const auto& opt = options[id];
+        if (!IsBound(id))
+        {
+            ValidateOption(opt);
+            return;
+        }
+        // значения привязанной опции - в структуре; считаем записанные
+        if (bound_counts[id] < (opt.IsMultiValue() ? opt.GetMinArgs() : 1))
+            AddError({ParseErrorCode::MissingValue, opt.GetLongOption(), "No value for option " + opt.GetLongOption()});
+    });
+}
+
+// Каждое ограничение проверяется пересечением его множества опций с множеством указанных - по 64 опции за операцию
+void ArgParser::CheckConstraints(const OptionBitset& given, std::vector<ParseError>& out) const
+{
+    const auto names = [this](const OptionBitset& set) { // имена опций множества через запятую
+        std::string list;
+        set.ForEach([this, &list](size_t id){
+            list += (list.empty() ? "" : ", ") + options[id].GetLongOption();
+        });
+        return list;
+    };
+    const auto firstName = [this](const OptionBitset& set) {
+        std::string name;
+        set.ForEach([this, &name](size_t id){
+            if (name.empty())
+                name = options[id].GetLongOption();
+        });
+        return name;
+    };
+
+    for (const auto& constraint: constraints)
+    {
+        if (constraint.kind == Constraint::Kind::MutuallyExclusive && constraint.members.CountCommon(given) > 1)
+        {
+            auto conflicting = constraint.members;
+            conflicting &= given;
+            out.push_back({ParseErrorCode::ConstraintViolation, firstName(conflicting),
+                           "Options " + names(conflicting) + " are mutually exclusive", {}});
+        }
+        else if (constraint.kind == Constraint::Kind::AtLeastOneOf && !constraint.members.Intersects(given))
+        {
+            out.push_back({ParseErrorCode::ConstraintViolation, firstName(constraint.members),
+                           "One of options " + names(constraint.members) + " is required", {}});
+        }
+        else if (constraint.kind == Constraint::Kind::Requires && given.Test(constraint.option) &&
+                 !given.Contains(constraint.members))
+        {
+            auto missing = constraint.members;
+            missing.AndNot(given);
+            const auto& name = options[constraint.option].GetLongOption();
+            out.push_back({ParseErrorCode::ConstraintViolation, name,
+                           "Option " + name + " requires " + names(missing), {}});
+        }
+    }
+}
+
+namespace
+{
+    // Добавить в args аргументы text, разделенные пробельными символами
+    void SplitResponseText(std::string_view text, std::vector<std::string_view>& args)
+    {
+        size_t pos = text.find_first_not_of(" \t\r\n");
+        while (pos != std::string_view::npos)
+        {
+            const auto end = text.find_first_of(" \t\r\n", pos);
+            args.push_back(text.substr(pos, end - pos));
+            pos = text.find_first_not_of(" \t\r\n", end);
+        }
+    }
+}
+
+void ArgParser::ExpandResponseFiles(std::vector<std::string_view>& args)
+{
+    std::vector<std::string_view> expanded;
+    expanded.reserve(args.size());
+    for (size_t argIndex = 0; argIndex < args.size(); ++argIndex)
+    {
+        const auto arg = args[argIndex];
+        if (argIndex == 0 || arg.size() < 2 || arg[0] != '@') // имя программы и обычные аргументы - как есть
+        {
+            expanded.push_back(arg);
+            continue;
+        }
+
+        // аргументы файла - представления внутри отображенного в память файла, разделенные пробельными символами
+        const auto text = response_files.emplace_back(std::string(arg.substr(1))).View();
+        if (DetectCompression(text) != Compression::None) // сжатый файл: в памяти только аргументы, не весь текст
+        {
+            if (!SupportsCompression(DetectCompression(text)))
+                throw ParseException({ParseErrorCode::InvalidArgument, std::string(arg),
+                                      "Compression of response file " + std::string(arg.substr(1)) + " is not supported"});
+            compressed_files.emplace_back().Split(text, expanded);
+            response_files.pop_back(); // сжатые данные больше не нужны
+            continue;
+        }
+        const size_t shards = response_shard_bytes ? std::min(Workers().Size(), text.size() / response_shard_bytes) : 0;
+        if (shards < 2) // небольшой файл - последовательно
+        {
+            SplitResponseText(text, expanded);
+            continue;
+        }
+
+        // границы сегментов сдвигаются на ближайший пробельный символ - аргумент целиком в одном сегменте
+        std::vector<size_t> bounds = {0};
+        for (size_t k = 1; k < shards; ++k)
+            bounds.push_back(std::min(text.find_first_of(" \t\r\n", std::max(bounds.back(), k * (text.size() / shards))),
+                                      text.size()));
+        bounds.push_back(text.size());
+
+        std::vector<std::vector<std::string_view>> shardArgs(shards);
+        std::vector<std::vector<PreparedArg>> shardPrepared(shards);
+        std::vector<std::future<void>> done;
+        done.reserve(shards);
+        for (size_t k = 0; k < shards; ++k)
+        {
+            done.push_back(Workers().Submit([this, &shardArgs, &shardPrepared, k, shard = text.substr(bounds[k], bounds[k + 1] - bounds[k])]{
+                PrepareShard(shard, shardArgs[k], shardPrepared[k]);
+            }));
+        }
+        std::exception_ptr failure; // дожидаемся всех сегментов: они пишут в локальные буферы
+        for (auto& shard: done)
+        {
+            try
+            {
+                shard.get();
+            }
+            catch (...)
+            {
+                if (!failure)
+                    failure = std::current_exception();
+            }
+        }
+        if (failure)
+            std::rethrow_exception(failure);
+
+        prepared.resize(expanded.size()); // аргументы до файла разбираются обычным путем
+        for (size_t k = 0; k < shards; ++k) // склеиваем сегменты по порядку
+        {
+            expanded.insert(expanded.end(), shardArgs[k].begin(), shardArgs[k].end());
+            std::move(shardPrepared[k].begin(), shardPrepared[k].end(), std::back_inserter(prepared));
+        }
+    }
+    args = std::move(expanded);
+}
+
+void ArgParser::PrepareShard(std::string_view text, std::vector<std::string_view>& args,
+                             std::vector<PreparedArg>& prepared) const
+{
+    SplitResponseText(text, args);
+    const auto positional = std::find_if(options.begin(), options.end(), [](const auto& opt){
+        return opt.IsPositional();
+    });
+    const auto positionalId = positional == options.end() ? OptionTrie::NoOption
+                                                          : static_cast<uint32_t>(positional - options.begin());
+    prepared.reserve(args.size());
+    for (const auto arg: args)
+        prepared.push_back(PrepareArg(arg, positionalId));
+}
+
+ArgParser::PreparedArg ArgParser::PrepareArg(std::string_view arg, uint32_t positionalId) const
+{
+    PreparedArg result;
+    result.lexed = true;
+    result.token = lexer.Next(arg, allow_abbreviations);
+    const auto& token = result.token;
+
+    // опция, которой достанется значение, если аргумент будет разобран как обычно
+    uint32_t id = OptionTrie::NoOption;
+    if (token.kind == TokenKind::Positional)
+    {
+        id = positionalId;
+        result.text = arg;
+    }
+    else if (token.has_value)
+    {
+        id = token.kind == TokenKind::LongOption ? token.option : lexer.ShortOption(token.name.back());
+        result.text = token.value;
+    }
+    if (id >= options.size())
+        return result;
+    // значения с разделителем, шаблоны, отрезки и привязанные поля заносятся обычным путем
+    const auto& opt = options[id];
+    if (IsBound(id) || opt.GetSeparator() || opt.GetGlobLimit() || opt.UsesRanges())
+        return result;
+
+    try
+    {
+        switch (opt.GetType())
+        {
+            case OptionType::IntegerOption:
+            case OptionType::EnumOption: result.value = PreparedValue(std::in_place_type<int>); break;
+            case OptionType::DoubleOption: result.value = PreparedValue(std::in_place_type<double>); break;
+            case OptionType::SizeOption: result.value = PreparedValue(std::in_place_type<uint64_t>); break;
+            case OptionType::DurationOption: result.value = PreparedValue(std::in_place_type<std::chrono::nanoseconds>); break;
+            case OptionType::StringOption:
+            case OptionType::PathOption: result.value = PreparedValue(std::in_place_type<std::string>); break;
+            default: return result;
+        }
+        std::visit([&opt, &result](auto& value){
+            if constexpr (!std::is_same_v<std::decay_t<decltype(value)>, std::monostate>)
+                ConvertValue(opt, result.text, value);
+        }, result.value);
+    }
+    catch (ParseException& e) // ошибка сработает, только если разбор дойдет до этого аргумента
+    {
+        result.error = std::make_shared<const ParseError>(e.GetError());
+    }
+    result.option = id;
+    return result;
+}
+
+bool ArgParser::UsePrepared(uint32_t id, size_t argIndex, std::string_view value)
+{
+    if (argIndex >= prepared.size())
+        return false;
+    const auto& arg = prepared[argIndex];
+    // значение подготовлено для этой же опции и этого же текста (после перехода к позиционным аргумент - целиком)
+    if (arg.option != id || arg.text.data() != value.data() || arg.text.size() != value.size())
+        return false;
+    if (arg.error)
+        throw ParseException(*arg.error);
+    std::visit([this, id](const auto& converted){
+        if constexpr (!std::is_same_v<std::decay_t<decltype(converted)>, std::monostate>)
+            options[id].SetValue(converted);
+    }, arg.value);
+    CheckPath(id, value);
+    return true;
+}
+
+bool ArgParser::AddError(ParseError error)
+{
+    errors.push_back(std::move(error));
+    return false;
 }
 
 int ArgParser::GetIntValue(const std::string& longOpt) const
@@ -185,6 +1247,41 @@ int ArgParser::GetIntValue(const std::string& longOpt, size_t pos) const
     return GetOption(longOpt).GetInt(pos); // получение целочисленного значения в позиции pos MultiValue опции по ее имени
 }
 
+IntValues ArgParser::GetIntValues(const std::string& longOpt) const
+{
+    return IntValues(GetOption(longOpt)); // диапазон значений MultiValue опции по ее имени
+}
+
+double ArgParser::GetDoubleValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetDouble();
+}
+
+double ArgParser::GetDoubleValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetDouble(pos);
+}
+
+uint64_t ArgParser::GetSizeValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetSize();
+}
+
+uint64_t ArgParser::GetSizeValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetSize(pos);
+}
+
+std::chrono::nanoseconds ArgParser::GetDurationValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetDuration();
+}
+
+std::chrono::nanoseconds ArgParser::GetDurationValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetDuration(pos);
+}
+
 std::string ArgParser::GetStringValue(const std::string& longOpt) const
 {
     return GetOption(longOpt).GetString(); // получение строкового значения опции по ее имени
@@ -195,15 +1292,24 @@ std::string ArgParser::GetStringValue(const std::string& longOpt, size_t pos) co
     return GetOption(longOpt).GetString(pos); // получение строкового значения в позиции pos MultiValue опции по ее имени
 }
 
-CommandLineOption& ArgParser::GetOption(char shortOpt)
+int ArgParser::GetFileDescriptor(const std::string& longOpt, size_t pos) const
 {
-    // ищем опцию по ее короткому имени среди всех опций
-    const auto it = std::find_if(options.begin(), options.end(), [&shortOpt](const auto& opt){
-        return opt.GetShortOption() == shortOpt;
-    });
-    if (it == options.end()) // не найдено - ошибка
-        throw std::logic_error(std::string{"No option named "} + shortOpt);
-    return *it; // возвращаем ссылку на опцию
+    if (!(GetOption(longOpt).GetPathChecks() & PathPrefetch))
+        throw std::logic_error("Option " + longOpt + " does not prefetch files");
+    const auto id = option_index.at(longOpt);
+    if (id >= prefetched.size() || pos >= prefetched[id].size())
+        return -1;
+    return prefetched[id][pos].Get();
+}
+
+uint32_t ArgParser::GetShortOptionId(char shortOpt) const
+{
+    // ищем опцию по ее короткому имени в таблице автомата имен
+    const auto id = lexer.ShortOption(shortOpt);
+    if (id == OptionTrie::NoOption) // не найдено - ошибка
+        throw ParseException({ParseErrorCode::UnknownOption, std::string(1, shortOpt),
+                              std::string{"No option named "} + shortOpt});
+    return id; // возвращаем номер опции
 }
 
 CommandLineOption& ArgParser::GetOption(const std::string& longOpt)
@@ -214,13 +1320,38 @@ CommandLineOption& ArgParser::GetOption(const std::string& longOpt)
 
 const CommandLineOption& ArgParser::GetOption(const std::string& longOpt) const
 {
-    // ищем опцию по ее длинному имени среди всех опций
-    const auto it = std::find_if(options.begin(), options.end(), [&longOpt](const auto& opt){
-        return opt.GetLongOption() == longOpt;
-    });
-    if (it == options.end()) // не найдено - ошибка
+    // ищем опцию по ее длинному имени в индексе
+    const auto it = option_index.find(longOpt);
+    if (it == option_index.end()) // не найдено - ошибка
         throw std::logic_error("No option named " + longOpt);
-    return *it; // возвращаем ссылку на опцию
+    return options[it->second]; // возвращаем ссылку на опцию
+}
+
+uint32_t ArgParser::GetLongOptionId(const ArgToken& token)
+{
+    if (token.option == OptionTrie::Ambiguous) // сокращение подходит к нескольким опциям
+        throw ParseException({ParseErrorCode::AmbiguousOption, std::string(token.name),
+                              "Ambiguous option " + std::string(token.name)});
+    if (token.option == OptionTrie::NoOption) // не найдено - ошибка
+        throw UnknownOption(token.name);
+    return token.option;
+}
+
+ParseException ArgParser::UnknownOption(std::string_view longOpt)
+{
+    if (suggestions.Size() != options.size()) // дерево строится один раз, при первой опечатке
+    {
+        std::vector<std::string_view> names;
+        names.reserve(options.size());
+        for (const auto& opt: options)
+            names.push_back(opt.GetLongOption());
+        suggestions.Build(names);
+    }
+
+    ParseError error{ParseErrorCode::UnknownOption, std::string(longOpt), "No option named " + std::string(longOpt), {}};
+    for (const auto name: suggestions.Find(longOpt, MaxSuggestionDistance))
+        error.suggestions.emplace_back(name);
+    return ParseException(std::move(error));
 }
 
 CommandLineOption& ArgParser::GetPositionalArgument()
@@ -249,25 +1380,298 @@ void ArgParser::SetFlagOption(CommandLineOption& option)
 {
     auto type = option.GetType();
     if (type != OptionType::FlagOption && type != OptionType::HelpOption)
-        throw std::logic_error("No help option");
+        throw ParseException({ParseErrorCode::InvalidValue, option.GetLongOption(),
+                              "Value expected for option " + option.GetLongOption()});
     option.SetValue(true); // установка флага
 }
 
-void ArgParser::SetValueOption(CommandLineOption& option, const std::string& value)
+template<typename F>
+void ArgParser::ForEachValuePiece(const CommandLineOption& option, std::string_view value, F&& apply)
+{
+    const char separator = option.GetSeparator();
+    if (!separator) // одно значение
+    {
+        apply(value);
+        return;
+    }
+
+    // разделители ищутся по 16 байт за раз; части - представления внутри value
+    const char* first = value.data();
+    const char* const last = value.data() + value.size();
+    while (true)
+    {
+        const char* next = FindAnyOf(first, last, separator);
+        apply(std::string_view(first, static_cast<size_t>(next - first)));
+        if (next == last)
+            break;
+        first = next + 1;
+    }
+}
+
+void ArgParser::SetValueOption(CommandLineOption& option, std::string_view value)
+{
+    ForEachValuePiece(option, value, [&option](std::string_view piece){ SetSingleValue(option, piece); });
+}
+
+void ArgParser::SetOptionValue(uint32_t id, std::string_view value)
+{
+    const auto& opt = options[id];
+    if (!opt.GetGlobLimit() || !HasGlobMagic(value))
+        return StoreOptionValue(id, value);
+
+    std::vector<std::string> paths;
+    if (!ExpandGlob(value, opt.GetGlobLimit(), Workers(), paths))
+        throw ParseException({ParseErrorCode::InvalidValue, opt.GetLongOption(),
+                              "Pattern " + std::string(value) + " matches more than " +
+                              std::to_string(opt.GetGlobLimit()) + " paths", {}});
+    if (paths.empty()) // как в командной оболочке: шаблон без совпадений остается значением
+        return StoreOptionValue(id, value);
+    options[id].ReserveValues(paths.size()); // пути пишутся прямо в значения опции
+    for (const auto& path: paths)
+        StoreOptionValue(id, path);
+}
+
+ThreadPool& ArgParser::Workers()
+{
+    if (!workers) // работа упирается в файловую систему, а не в процессор - потоков не меньше четырех
+        workers = std::make_unique<ThreadPool>(std::max(4u, std::thread::hardware_concurrency()));
+    return *workers;
+}
+
+void ArgParser::StoreOptionValue(uint32_t id, std::string_view value)
+{
+    auto& opt = options[id];
+    if (!IsBound(id))
+        SetValueOption(opt, value);
+    else
+    {
+        if (opt.GetType() == OptionType::FlagOption) // флаг не принимает значения - ошибка
+            SetSingleValue(opt, value);
+        ForEachValuePiece(opt, value, [this, id](std::string_view piece){ WriteBound(id, piece); });
+    }
+    CheckPath(id, value);
+}
+
+void ArgParser::CheckPath(size_t id, std::string_view value)
+{
+    if (!path_checked.Test(id))
+        return;
+    const auto& opt = options[id];
+    ForEachValuePiece(opt, value, [this, &opt, id](std::string_view piece){
+        path_checker.Add(Workers(), id, opt.GetLongOption(), piece, opt.GetPathChecks());
+    });
+}
+
+void ArgParser::WriteBound(size_t id, std::string_view value)
+{
+    bindings[id](options[id], bound_target, value);
+    ++bound_counts[id];
+}
+
+ArgParser::Binding& ArgParser::AddBinding(const std::type_info& type, const std::string& longOpt, bool accepts)
+{
+    if (bound_type && *bound_type != type) // одна таблица привязок - для одной структуры
+        throw std::logic_error("Options are bound to another struct");
+    if (!accepts)
+        throw std::logic_error("Field type does not match option " + longOpt);
+    const auto id = option_index.at(longOpt);
+    bound_type = &type;
+    bindings.resize(options.size());
+    return bindings[id];
+}
+
+bool ArgParser::ParseBound(const std::type_info& type, void* target, std::vector<std::string_view> args)
+{
+    if (bound_type && *bound_type != type)
+        throw std::logic_error("Options are bound to another struct");
+    bound_target = target;
+    bound_counts.assign(options.size(), 0);
+    try
+    {
+        const bool result = ParseTokens(std::move(args));
+        bound_target = nullptr;
+        return result;
+    }
+    catch (...)
+    {
+        bound_target = nullptr; // структура может не пережить исключение
+        throw;
+    }
+}
+
+void ArgParser::SetSingleValue(CommandLineOption& option, std::string_view value)
 {
     // установка значения
     const auto type = option.GetType();
-    if (type == OptionType::IntegerOption) // для целого числа
-        option.SetValue(std::stoi(value));
-    else if (type == OptionType::StringOption) // для строки
-        option.SetValue(value);
+    if (type == OptionType::IntegerOption && option.UsesRanges()) // список чисел и диапазонов: 1,5,9-100000
+    {
+        const auto wrong = [&option, value]() {
+            return ParseException({ParseErrorCode::InvalidValue, option.GetLongOption(),
+                                   "Wrong integer range " + std::string(value)});
+        };
+        const char* pos = value.data();
+        const char* const end = value.data() + value.size();
+        while (true)
+        {
+            int first = 0; // число или диапазон <first>-<last>; знак минус перед числом допускается
+            auto parsed = std::from_chars(pos, end, first);
+            if (parsed.ec != std::errc{})
+                throw wrong();
+            int last = first;
+            if (parsed.ptr != end && *parsed.ptr == '-')
+            {
+                parsed = std::from_chars(parsed.ptr + 1, end, last);
+                if (parsed.ec != std::errc{} || last < first)
+                    throw wrong();
+            }
+            option.AddRange(first, last); // отрезок не разворачивается
+            if (parsed.ptr == end)
+                break;
+            if (*parsed.ptr != ',')
+                throw wrong();
+            pos = parsed.ptr + 1;
+        }
+    }
+    else if (type == OptionType::IntegerOption || type == OptionType::EnumOption) // целое или перечисление
+    {
+        int number = 0;
+        ConvertValue(option, value, number);
+        option.SetValue(number);
+    }
+    else if (type == OptionType::StringOption || type == OptionType::PathOption) // для строки (и пути)
+        option.SetValue(std::string(value));
+    else if (type == OptionType::DoubleOption)
+    {
+        double number = 0;
+        ConvertValue(option, value, number);
+        option.SetValue(number);
+    }
+    else if (type == OptionType::SizeOption)
+    {
+        uint64_t size = 0;
+        ConvertValue(option, value, size);
+        option.SetValue(size);
+    }
+    else if (type == OptionType::DurationOption)
+    {
+        std::chrono::nanoseconds duration{};
+        ConvertValue(option, value, duration);
+        option.SetValue(duration);
+    }
+    else if (type == OptionType::CustomOption) // пользовательский тип: преобразователь возвращает код ошибки
+    {
+        const auto ec = option.SetCustomValue(value);
+        if (ec != std::errc{})
+            throw ParseException({ParseErrorCode::InvalidValue, option.GetLongOption(),
+                                  "Wrong value " + std::string(value) + " for option " + option.GetLongOption() +
+                                  ": " + std::make_error_code(ec).message(), {}});
+    }
     else // другие типы не поддерживают операцию - ошибка
-        throw std::logic_error("Wrong option type");
+        throw ParseException({ParseErrorCode::InvalidValue, option.GetLongOption(),
+                              "Option " + option.GetLongOption() + " takes no value"});
+}
+
+void ArgParser::SetFlagOption(CommandLineOption& option, std::string_view value)
+{
+    bool flag = false;
+    ConvertValue(option, value, flag);
+    option.SetValue(flag);
+}
+
+// Значения опции собираются по приоритету: командная строка > окружение > конфигурация > по умолчанию.
+// Командная строка уже разобрана, поэтому за один проход по опциям для каждой не указанной
+// берется первый по приоритету имеющийся источник.
+void ArgParser::ApplyFallbacks()
+{
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+        if (seen.Test(i) || !ApplyFallback(i, options[i])) // указана в командной строке или значения нет
+            continue;
+        seen.Set(i);
+        from_fallback.Set(i);
+        if (options[i].GetType() == OptionType::FlagOption) // значение флага из окружения или конфигурации
+        {
+            if (options[i].GetFlag())
+                flag_values.Set(i);
+            else
+                flag_values.Reset(i);
+        }
+    }
+}
+
+bool ArgParser::ApplyFallback(size_t id, CommandLineOption& opt)
+{
+    const bool bound = IsBound(id) && &opt == &options[id]; // у копий опций (Reparse) привязок нет
+    const auto setValue = [this, &opt, id, bound](std::string_view value) {
+        if (opt.GetType() == OptionType::FlagOption)
+        {
+            SetFlagOption(opt, value); // значение флага нужно и битовому множеству
+            if (bound)
+                WriteBound(id, value);
+        }
+        else if (bound || &opt == &options[id]) // копии опций (Reparse) - без шаблонов и проверок путей
+            SetOptionValue(static_cast<uint32_t>(id), value);
+        else
+            SetValueOption(opt, value);
+    };
+
+    if (!opt.GetEnv().empty()) // окружение
+    {
+        if (const auto* value = Environment::Snapshot().Find(opt.GetEnv()))
+        {
+            setValue(*value);
+            return true;
+        }
+    }
+
+    if (id < config_values.size() && !config_values[id].empty()) // конфигурация
+    {
+        const auto& values = config_values[id];
+        if (opt.IsMultiValue()) // все значения по порядку
+            std::for_each(values.begin(), values.end(), setValue);
+        else // одиночная опция - последнее значение
+            setValue(values.back());
+        return true;
+    }
+    return false;
 }
 
 bool ArgParser::GetFlag(const std::string& longOpt) const
 {
-    return GetOption(longOpt).GetFlag(); // значение флага по его длинному имени
+    const auto id = FlagId(longOpt);
+    if (id < flag_values.Size()) // разбор уже был - значение в битовом множестве
+        return flag_values.Test(id);
+    return options[id].GetFlag(); // значение флага по его длинному имени
+}
+
+uint32_t ArgParser::OptionId(const std::string& longOpt) const
+{
+    const auto it = option_index.find(longOpt);
+    if (it == option_index.end())
+        throw std::logic_error("No option named " + longOpt);
+    return static_cast<uint32_t>(it->second);
+}
+
+size_t ArgParser::FlagId(const std::string& longOpt) const
+{
+    const auto it = option_index.find(longOpt);
+    if (it == option_index.end() || options[it->second].GetType() != OptionType::FlagOption)
+        throw std::logic_error("No flag named " + longOpt);
+    return it->second;
+}
+
+const std::string& ArgParser::GetSubcommandName() const
+{
+    if (!active_subcommand) // подкоманда не указана - ошибка
+        throw std::logic_error("No subcommand");
+    return active_subcommand->name;
+}
+
+ArgParser& ArgParser::GetSubcommand()
+{
+    if (!subcommand_parser)
+        throw std::logic_error("No subcommand");
+    return *subcommand_parser;
 }
 
 bool ArgParser::Help()
@@ -290,6 +1694,7 @@ bool ArgParser::Help()
 //      --sum,  add args[default = false]
 //      --mult,  multiply args[default = false]
 // -h,  --help,  Display this help and exit
+// <подкоманды, если есть>
 //
 std::string ArgParser::HelpDescription()
 {
@@ -323,6 +1728,13 @@ std::string ArgParser::HelpDescription()
             oss << opt << '\n';
     }
     oss << helpOption << '\n';
+
+    if (!subcommands.empty()) // подкоманды - только имена и описания, их парсеры не создаются
+    {
+        oss << "Commands:\n";
+        for (const auto& cmd: subcommands)
+            oss << "     " << cmd.name << ",  " << cmd.description << '\n';
+    }
     return oss.str();
 }
 
@@ -1,9 +1,33 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
+#include "ArgLexer.h"
+#include "BKTree.h"
+#include "BinaryArgs.h"
+#include "CompressedArgs.h"
 #include "CommandLineOption.h"
+#include "MappedFile.h"
+#include "OptionBitset.h"
+#include "OptionTrie.h"
+#include "ParseCache.h"
+#include "ParseError.h"
+#include "ParseResult.h"
+#include "ThreadPool.h"
+#include "PathChecker.h"
+#include "ValueConverter.h"
 
 namespace ArgumentParser
 {
@@ -36,28 +60,237 @@ public:
     CommandLineOption& AddFlag(std::string longOpt, std::string desc);
     CommandLineOption& AddFlag(char shortOpt, std::string longOpt, std::string desc);
 
+    // Добавить вещественную опцию
+    CommandLineOption& AddDoubleArgument(std::string longOpt);
+    CommandLineOption& AddDoubleArgument(char shortOpt, std::string longOpt);
+    CommandLineOption& AddDoubleArgument(std::string longOpt, std::string desc);
+    CommandLineOption& AddDoubleArgument(char shortOpt, std::string longOpt, std::string desc);
+
+    // Добавить опцию размера в байтах (64K, 1.5G, 2GiB)
+    CommandLineOption& AddSizeArgument(std::string longOpt);
+    CommandLineOption& AddSizeArgument(char shortOpt, std::string longOpt);
+    CommandLineOption& AddSizeArgument(std::string longOpt, std::string desc);
+    CommandLineOption& AddSizeArgument(char shortOpt, std::string longOpt, std::string desc);
+
+    // Добавить опцию длительности (250ms, 3s, 1h30m)
+    CommandLineOption& AddDurationArgument(std::string longOpt);
+    CommandLineOption& AddDurationArgument(char shortOpt, std::string longOpt);
+    CommandLineOption& AddDurationArgument(std::string longOpt, std::string desc);
+    CommandLineOption& AddDurationArgument(char shortOpt, std::string longOpt, std::string desc);
+
+    // Добавить опцию-путь: строка, которую можно проверить на существование и доступность (MustExist, MustBeReadable).
+    // Проверки идут пакетами на пуле потоков параллельно с разбором остальных аргументов; ошибки - в ошибках разбора.
+    CommandLineOption& AddPathArgument(std::string longOpt);
+    CommandLineOption& AddPathArgument(char shortOpt, std::string longOpt);
+    CommandLineOption& AddPathArgument(std::string longOpt, std::string desc);
+    CommandLineOption& AddPathArgument(char shortOpt, std::string longOpt, std::string desc);
+
+    // Добавить опцию-перечисление: значение - одно из имен choices, хранится как соответствующее значение E
+    template<typename E>
+    CommandLineOption& AddEnumArgument(std::string longOpt, std::initializer_list<std::pair<std::string_view, E>> choices)
+    {
+        return AddEnumArgument({}, std::move(longOpt), {}, choices);
+    }
+    template<typename E>
+    CommandLineOption& AddEnumArgument(char shortOpt, std::string longOpt, std::string desc,
+                                       std::initializer_list<std::pair<std::string_view, E>> choices)
+    {
+        static_assert(std::is_enum_v<E>, "AddEnumArgument expects an enum type");
+        std::vector<std::pair<std::string_view, int>> values;
+        values.reserve(choices.size());
+        for (const auto& [name, value]: choices)
+            values.emplace_back(name, static_cast<int>(value));
+        return AddOption(OptionType::EnumOption, shortOpt, std::move(longOpt), std::move(desc)).Choices(values);
+    }
+
+    // Добавить опцию пользовательского типа T; преобразователь текста в T задается через Converter:
+    // parser.AddArgument<Endpoint>("listen").Converter(ParseEndpoint)
+    template<typename T>
+    TypedOption<T> AddArgument(std::string longOpt) { return AddArgument<T>({}, std::move(longOpt), {}); }
+    template<typename T>
+    TypedOption<T> AddArgument(char shortOpt, std::string longOpt, std::string desc)
+    {
+        return TypedOption<T>(AddOption(OptionType::CustomOption, shortOpt, std::move(longOpt), std::move(desc)));
+    }
+
     // Добавить опцию справки
     CommandLineOption& AddHelp(char shortOpt, std::string longOpt, std::string desc);
 
+    // Функция, добавляющая опции в парсер подкоманды
+    using SubcommandFactory = std::function<void(ArgParser&)>;
+
+    // Добавить подкоманду name. Парсер подкоманды создается (и factory вызывается)
+    // только если подкоманда указана в аргументах; все последующие аргументы разбирает он.
+    ArgParser& AddSubcommand(std::string name, SubcommandFactory factory);
+    ArgParser& AddSubcommand(std::string name, std::string desc, SubcommandFactory factory);
+
+    // Обработчик аргумента с неизвестной опцией: true - аргумент обработан и пропускается, false - ошибка разбора
+    using UnknownOptionHandler = std::function<bool(std::string_view)>;
+
+    // Вызывать handler для аргументов с неизвестными опциями (--unknown, -x) вместо ошибки
+    ArgParser& OnUnknownOption(UnknownOptionHandler handler);
+
+    // Разрешить однозначные сокращения длинных опций (--verb вместо --verbose)
+    ArgParser& AllowAbbreviations(bool allow = true);
+
+    // Разрешить файлы аргументов: аргумент @<путь> заменяется аргументами из файла (разделены пробельными символами).
+    // Файл отображается в память, и аргументы разбираются прямо в нем. Файлы, сжатые gzip или zstd (по сигнатуре),
+    // распаковываются потоком через буфер фиксированного размера, если библиотека найдена при сборке.
+    ArgParser& AllowResponseFiles(bool allow = true);
+
+    // Разбирать большие файлы аргументов (от minShardBytes на сегмент) параллельно: файл делится по пробельным
+    // символам на сегменты, и в каждом сегменте аргументы выделяются, сопоставляются с опциями и значения
+    // преобразуются в своем потоке. Затем значения по порядку заносятся в опции - результат тот же,
+    // что и у последовательного разбора (включая переход к позиционным, справку и первую ошибку).
+    ArgParser& ParallelResponseFiles(size_t minShardBytes = 1 << 20);
+
+    // Ограничения групп опций. Опция считается указанной, если получила значение из командной строки,
+    // окружения или конфигурации (значение по умолчанию не в счет). Все нарушения попадают в ошибки разбора.
+
+    // Из опций names можно указать не больше одной
+    ArgParser& MutuallyExclusive(const std::vector<std::string>& names);
+    // Из опций names нужно указать хотя бы одну
+    ArgParser& AtLeastOneOf(const std::vector<std::string>& names);
+    // Если указана опция longOpt, должны быть указаны и все опции names
+    ArgParser& Requires(const std::string& longOpt, const std::vector<std::string>& names);
+
+    // Загрузить файл конфигурации со строками вида <длинное_имя>=<значение> ('#' - комментарий).
+    // Значения из файла используются для опций, не указанных ни в командной строке, ни в окружении.
+    // Возвращает false, если файл не читается или содержит неизвестную опцию.
+    bool LoadConfig(const std::string& path);
+
     // Разобрать аргументы и вернуть успешен ли разбор
     bool Parse(int argc, char** argv);
     bool Parse(const std::vector<std::string>& args);
 
+    // Записывать значения опции longOpt при ParseInto прямо в поле member структуры S, без хранения в опции.
+    // Все привязки парсера - к полям одной структуры. Тип поля - тип значения опции (для MultiValue - std::vector);
+    // значение по умолчанию в поле не записывается.
+    template<typename S, typename T>
+    ArgParser& Bind(T S::* member, const std::string& longOpt)
+    {
+        const auto& opt = GetOption(longOpt);
+        const bool accepts = AcceptsOptionType<T>(opt.GetType()) && !opt.UsesRanges() &&
+            IsValueVector<T>::value == opt.IsMultiValue();
+        AddBinding(typeid(S), longOpt, accepts) = [member](const CommandLineOption& option, void* object,
+                                                           std::string_view value) {
+            ConvertValue(option, value, static_cast<S*>(object)->*member);
+        };
+        return *this;
+    }
+
+    // Разобрать аргументы, записывая значения привязанных (Bind) опций в target
+    template<typename S>
+    bool ParseInto(S& target, int argc, char** argv)
+    {
+        return ParseBound(typeid(S), &target, std::vector<std::string_view>(argv, argv + argc));
+    }
+    template<typename S>
+    bool ParseInto(S& target, const std::vector<std::string>& args)
+    {
+        return ParseBound(typeid(S), &target, std::vector<std::string_view>(args.begin(), args.end()));
+    }
+
+    // Зафиксировать набор опций: после этого добавлять опции, подкоманды и конфигурацию нельзя
+    ArgParser& Freeze();
+
+    // Включить кэш результатов ParseCached на capacity последних разных списков аргументов (фиксирует парсер)
+    ArgParser& EnableCache(size_t capacity);
+
+    // Разобрать аргументы и вернуть неизменяемый результат. Для уже встречавшегося списка аргументов
+    // результат берется из кэша без разбора. Значения опций парсера сбрасываются перед каждым разбором;
+    // внешние хранилища (StoreValue) заполняются только при промахе кэша.
+    std::shared_ptr<const ParseResult> ParseCached(const std::vector<std::string>& args);
+
+    // Правка списка аргументов для повторного разбора
+    struct ArgEdit
+    {
+        enum class Kind { Replace, Insert, Erase };
+
+        Kind kind;          // заменить, вставить или удалить аргумент
+        size_t index;       // номер аргумента (0 - имя программы, его править нельзя)
+        std::string value;  // новый аргумент (для Replace и Insert)
+    };
+
+    // Разобрать аргументы результата previous (полученного от этого парсера) с правкой edit.
+    // Заново обрабатываются только затронутые аргументы и опции, которые они задают, и проверяются
+    // только эти опции; остальные снимки опций берутся из previous. Если правка меняет разбиение на
+    // опции и позиционные аргументы (или затрагивает справку, подкоманды, файлы аргументов), выполняется полный разбор.
+    // Внешние хранилища (StoreValue) при разборе по частям не заполняются.
+    std::shared_ptr<const ParseResult> Reparse(const ParseResult& previous, const ArgEdit& edit);
+
+    // Счетчики попаданий и промахов кэша
+    const ParseCache::Stats& GetCacheStats() const { return cache.GetStats(); }
+
+    // Разобрать командную строку целиком (включая имя программы) с кавычками и экранированием как в POSIX shell
+    bool ParseCommandLine(std::string_view commandLine);
+
+    // Разобрать двоичные аргументы (BinaryArgsWriter): значения уже в своем типе, без выделения аргументов из текста
+    // и преобразования чисел. Окружение, конфигурация, проверки и ограничения - как у Parse.
+    bool ParseBinary(const std::byte* data, size_t size);
+    bool ParseBinary(const std::vector<std::byte>& data) { return ParseBinary(data.data(), data.size()); }
+
+    // Номер опции с (длинным) именем longOpt (для BinaryArgsWriter)
+    uint32_t OptionId(const std::string& longOpt) const;
+
+    // Ошибки последнего разбора (пусто, если разбор успешен)
+    const std::vector<ParseError>& GetErrors() const { return errors; }
+
     // Получить значение флага опции с (длинным) именем longOpt
     bool GetFlag(const std::string& longOpt) const;
 
+    // Номер флага с (длинным) именем longOpt в FlagsBitset
+    size_t FlagId(const std::string& longOpt) const;
+
+    // Значения всех флагов после разбора: бит FlagId(имя) - значение флага (с учетом значения по умолчанию)
+    const OptionBitset& FlagsBitset() const { return flag_values; }
+
     // Получить целочисленное значение опции с (длинным) именем longOpt
     int GetIntValue(const std::string& longOpt) const;
 
     // Получить целочисленное значение в позиции pos (MultiValue) опции с (длинным) именем longOpt
     int GetIntValue(const std::string& longOpt, size_t pos) const;
 
+    // Получить все целочисленные значения (MultiValue) опции с (длинным) именем longOpt для обхода
+    IntValues GetIntValues(const std::string& longOpt) const;
+
+    // Получить вещественное значение, размер или длительность опции с (длинным) именем longOpt (и в позиции pos для MultiValue)
+    double GetDoubleValue(const std::string& longOpt) const;
+    double GetDoubleValue(const std::string& longOpt, size_t pos) const;
+    uint64_t GetSizeValue(const std::string& longOpt) const;
+    uint64_t GetSizeValue(const std::string& longOpt, size_t pos) const;
+    std::chrono::nanoseconds GetDurationValue(const std::string& longOpt) const;
+    std::chrono::nanoseconds GetDurationValue(const std::string& longOpt, size_t pos) const;
+
+    // Получить значение перечисления опции с (длинным) именем longOpt (и в позиции pos для MultiValue)
+    template<typename E>
+    E GetEnumValue(const std::string& longOpt) const { return static_cast<E>(GetIntValue(longOpt)); }
+    template<typename E>
+    E GetEnumValue(const std::string& longOpt, size_t pos) const { return static_cast<E>(GetIntValue(longOpt, pos)); }
+
+    // Получить значение пользовательского типа T опции с (длинным) именем longOpt (и в позиции pos для MultiValue)
+    template<typename T>
+    const T& GetValue(const std::string& longOpt, size_t pos = 0) const { return GetOption(longOpt).GetCustom<T>(pos); }
+
     // Получить строковое значение опции с (длинным) именем longOpt
     std::string GetStringValue(const std::string& longOpt) const;
 
     // Получить строковое значение в позиции pos (MultiValue) опции с (длинным) именем longOpt
     std::string GetStringValue(const std::string& longOpt, size_t pos) const;
 
+    // Дескриптор файла, открытого заранее (Prefetch), для значения в позиции pos опции-пути longOpt.
+    // Дескриптором владеет парсер: он закрывается при следующем разборе; -1 - файл не открылся.
+    int GetFileDescriptor(const std::string& longOpt, size_t pos = 0) const;
+
+    // Указана ли подкоманда
+    bool HasSubcommand() const { return active_subcommand != nullptr; }
+
+    // Имя указанной подкоманды
+    const std::string& GetSubcommandName() const;
+
+    // Парсер указанной подкоманды
+    ArgParser& GetSubcommand();
+
     // Запрашивается ли справка
     bool Help();
 
@@ -65,26 +298,193 @@ public:
     std::string HelpDescription();
 
 private:
+    struct PreparedArg;
+
     // Вспомогательные методы
 
-    // Получить объект опции по короткому имени
-    CommandLineOption& GetOption(char shortOpt);
+    // Добавить опцию и занести ее в индекс имен
+    CommandLineOption& AddOption(OptionType type, char shortOpt, std::string longOpt, std::string desc);
+    // Разобрать аргументы (представления в argv, строках или файлах аргументов)
+    bool ParseTokens(std::vector<std::string_view> args);
+    // Подготовка к разбору: автомат имен, сброс масок, проверок путей и заранее открытых файлов
+    void StartParse();
+    // Завершение разбора: результаты проверок путей, обязательные опции и ограничения групп; успешен ли разбор
+    bool FinishParse();
+    // Установить двоичное значение value опции с номером id; true - запрошена справка
+    bool SetBinaryValue(uint32_t id, std::string_view value);
+    // Запись значения в поле структуры: (опция, структура, текст значения)
+    using Binding = std::function<void(const CommandLineOption&, void*, std::string_view)>;
+    // Проверить привязку опции longOpt к структуре type и вернуть ее место в таблице
+    Binding& AddBinding(const std::type_info& type, const std::string& longOpt, bool accepts);
+    // Разобрать аргументы с записью привязанных опций в target (структуру типа type)
+    bool ParseBound(const std::type_info& type, void* target, std::vector<std::string_view> args);
+    // Заменить аргументы @<путь> содержимым файлов
+    void ExpandResponseFiles(std::vector<std::string_view>& args);
+    // Выделить аргументы сегмента text файла аргументов и подготовить их (PrepareArg)
+    void PrepareShard(std::string_view text, std::vector<std::string_view>& args,
+                      std::vector<PreparedArg>& prepared) const;
+    // Разобрать аргумент arg заранее: вид, опция и преобразованное значение (positionalId - позиционная опция)
+    PreparedArg PrepareArg(std::string_view arg, uint32_t positionalId) const;
+    // Занести в опцию id значение, заранее преобразованное для аргумента argIndex; false, если его нет
+    bool UsePrepared(uint32_t id, size_t argIndex, std::string_view value);
+    // Есть ли в аргументе token неизвестная опция
+    bool HasUnknownOption(const ArgToken& token) const;
+    // Вызвать apply(номер опции, значение или nullptr для флага) для каждой опции аргумента token.
+    // Перебор прекращается, если apply вернул true; тогда и результат - true.
+    template<typename F>
+    bool ForEachOptionValue(const ArgToken& token, F&& apply);
+    // Получить номер опции по короткому имени
+    uint32_t GetShortOptionId(char shortOpt) const;
     // Получить объект опции по длинному имени
     CommandLineOption& GetOption(const std::string& longOpt);
     // Получить объект опции по длинному имени (перегрузка для константных объектов)
     const CommandLineOption& GetOption(const std::string& longOpt) const;
+    // Получить номер длинной опции, найденной лексическим анализатором (ошибка, если не найдена)
+    uint32_t GetLongOptionId(const ArgToken& token);
+    // Ошибка неизвестной опции с похожими именами зарегистрированных опций
+    ParseException UnknownOption(std::string_view longOpt);
+    // Разобрать аргументы с записью сведений для Reparse и вернуть снимок
+    std::shared_ptr<const ParseResult> ParseToResult(const std::vector<std::string>& args);
+    // Разобрать по частям; nullptr, если правка требует полного разбора
+    std::shared_ptr<const ParseResult> ReparseIncrementally(const ParseResult& previous, const ArgEdit& edit,
+                                                            std::vector<std::string> args);
+    // Снимок текущих значений опций и ошибок
+    std::shared_ptr<const ParseResult> Snapshot() const;
+    // Добавить ошибку разбора; всегда возвращает false
+    bool AddError(ParseError error);
     // Получить объект позиционного аргумента (аргументов)
     CommandLineOption& GetPositionalArgument();
     // Получить объект опции справки
     const CommandLineOption& GetHelpOption() const;
     // Установить флаг (true) указанного объекта option
     static void SetFlagOption(CommandLineOption& option);
-    // Установить значение (value) указанного объекта option
-    static void SetValueOption(CommandLineOption& option, const std::string& value);
+    // Установить значение (value) указанного объекта option; с разделителем (Separator) - каждую часть value
+    static void SetValueOption(CommandLineOption& option, std::string_view value);
+    // Вызвать apply для каждой части value по разделителю опции option (или для value целиком)
+    template<typename F>
+    static void ForEachValuePiece(const CommandLineOption& option, std::string_view value, F&& apply);
+    // Установить значение опции с номером id: в привязанное поле структуры или в саму опцию.
+    // Шаблон у опции с Glob сначала разворачивается в пути.
+    void SetOptionValue(uint32_t id, std::string_view value);
+    // То же без разворачивания шаблонов
+    void StoreOptionValue(uint32_t id, std::string_view value);
+    // Пул потоков для фоновых проверок путей и обхода каталогов (создается при первом обращении)
+    ThreadPool& Workers();
+    // Привязана ли опция с номером id к полю структуры текущего ParseInto
+    bool IsBound(size_t id) const { return bound_target && id < bindings.size() && bindings[id]; }
+    // Записать значение в поле, привязанное к опции с номером id
+    void WriteBound(size_t id, std::string_view value);
+    // Установить одно значение (value) указанного объекта option
+    static void SetSingleValue(CommandLineOption& option, std::string_view value);
+    // Установить значение флага option из текста (пусто, "0", "false", "no", "off" - false, иначе true)
+    static void SetFlagOption(CommandLineOption& option, std::string_view value);
+    // Заполнить опции, не указанные в командной строке: окружение, затем конфигурация (по умолчанию - остаются как есть)
+    void ApplyFallbacks();
+    // То же для одной опции opt с номером id, не указанной в командной строке; возвращает, получила ли опция значение
+    bool ApplyFallback(size_t id, CommandLineOption& opt);
+    // Поставить в очередь проверки пути value опции с номером id (если у нее есть проверки)
+    void CheckPath(size_t id, std::string_view value);
+    // Построить автомат имен опций
+    void BuildLexer();
+    // Построить маски флагов, проверок путей и обязательных опций по текущим настройкам опций
+    void BuildMasks();
+    // Установить кластер коротких флагов (-abc) маской по символам; false, если среди них есть не флаг
+    bool SetShortFlags(std::string_view names);
+    // Добавить ошибку, если у опции нет значения (или их недостаточно)
+    void ValidateOption(const CommandLineOption& opt);
+    // Проверить опции, которые по маскам могут быть некорректны (вместо проверки всех опций)
+    void ValidateRequired();
+    // Множество опций по списку длинных имен
+    OptionBitset OptionSet(const std::vector<std::string>& names) const;
+    // Добавить в out ошибки нарушенных ограничений групп для множества указанных опций given
+    void CheckConstraints(const OptionBitset& given, std::vector<ParseError>& out) const;
+
+private:
+    // Максимальное расстояние Левенштейна для предлагаемых вместо неизвестной опции имен
+    static constexpr size_t MaxSuggestionDistance = 2;
+
+    // Описание подкоманды: парсер не создается до тех пор, пока подкоманда не выбрана
+    struct Subcommand
+    {
+        std::string name;           // имя подкоманды
+        std::string description;    // описание для справки
+        SubcommandFactory factory;  // функция настройки парсера подкоманды
+    };
+
+    // Положение флага в битовом множестве: слово и маска бита в нем (0 - символ не флаг)
+    struct FlagMask
+    {
+        uint32_t word = 0;
+        uint64_t bit = 0;
+    };
+
+    // Значение, преобразованное заранее (параллельный разбор файлов аргументов)
+    using PreparedValue = std::variant<std::monostate, int, double, uint64_t, std::chrono::nanoseconds, std::string>;
+
+    // Аргумент файла, разобранный заранее в своем сегменте
+    struct PreparedArg
+    {
+        bool lexed = false;                         // token заполнен
+        ArgToken token;                             // вид аргумента и опция
+        uint32_t option = OptionTrie::NoOption;     // опция, для которой преобразовано value
+        std::string_view text;                      // текст преобразованного значения (внутри аргумента)
+        PreparedValue value;                        // преобразованное значение
+        std::shared_ptr<const ParseError> error;    // ошибка преобразования (разбор остановится на ней)
+    };
+
+    // Ограничение группы опций
+    struct Constraint
+    {
+        enum class Kind { MutuallyExclusive, AtLeastOneOf, Requires };
+
+        Kind kind;              // вид ограничения
+        size_t option;          // опция, от которой зависят members (для Requires)
+        OptionBitset members;   // опции группы
+    };
 
 private:
     const std::string program_name;         // имя
-    std::vector<CommandLineOption> options; // опции
+    std::deque<CommandLineOption> options;  // опции (deque: ссылки на опции и их имена не меняются при добавлении)
+    std::unordered_map<std::string_view, size_t> option_index; // длинное имя -> номер опции в options
+    std::deque<MappedFile> config_files;    // загруженные файлы конфигурации (на них ссылаются значения)
+    std::vector<std::vector<std::string_view>> config_values; // значения из конфигурации по номеру опции
+    bool allow_abbreviations = false;       // разрешены ли сокращения длинных опций
+    bool allow_response_files = false;      // разрешены ли файлы аргументов
+    size_t response_shard_bytes = 0;        // наименьший сегмент параллельного разбора файла аргументов (0 - выключен)
+    std::vector<PreparedArg> prepared;      // аргументы, разобранные заранее (по номерам аргументов; пусто - нет)
+    ArgLexer lexer;                         // автомат имен опций для разбора аргументов
+    std::deque<MappedFile> response_files;  // отображенные файлы аргументов текущего разбора (на них ссылаются аргументы)
+    std::deque<CompressedArgs> compressed_files; // аргументы сжатых файлов аргументов текущего разбора
+    bool frozen = false;                    // зафиксирован ли набор опций
+    std::shared_ptr<const ParseResult::NameIndex> frozen_index; // индекс имен для результатов разбора
+    ParseCache cache;                       // кэш результатов ParseCached
+    bool record_sources = false;            // записывать ли, какие аргументы задали значения опций
+    std::vector<std::vector<uint32_t>> option_sources; // номера аргументов со значениями каждой опции
+    size_t positional_start = 0;            // первый позиционный аргумент последнего разбора (или их количество)
+    bool stopped_early = false;             // разбор остановлен справкой или подкомандой
+    BKTree suggestions;                     // дерево длинных имен для подсказок при опечатках
+    std::vector<ParseError> errors;         // ошибки последнего разбора
+    std::vector<Constraint> constraints;    // ограничения групп опций
+    OptionBitset required;                  // опции, которым нужно значение (нет значения по умолчанию)
+    OptionBitset counted;                   // MultiValue опции, которым мало одного значения
+    OptionBitset seen;                      // опции, получившие значение при последнем разборе
+    OptionBitset from_fallback;             // опции, получившие значение из окружения или конфигурации
+    OptionBitset path_checked;              // опции-пути с проверками (MustExist, MustBeReadable)
+    std::unique_ptr<ThreadPool> workers;    // пул потоков для работы с файловой системой
+    PathChecker path_checker;               // фоновые проверки путей текущего разбора
+    std::vector<std::vector<FileHandle>> prefetched; // открытые заранее файлы по номерам опций (Prefetch)
+    OptionBitset flag_values;               // значения флагов по номерам опций
+    OptionBitset flag_defaults;             // значения флагов по умолчанию
+    OptionBitset flag_setters;              // флаги, которые устанавливаются через опцию (StoreValue, Action)
+    std::array<FlagMask, 256> short_flags{}; // короткое имя -> положение флага в flag_values
+    std::vector<Binding> bindings;          // номер опции -> запись в поле структуры (Bind)
+    const std::type_info* bound_type = nullptr; // структура, к полям которой привязаны опции
+    void* bound_target = nullptr;           // структура текущего ParseInto
+    std::vector<size_t> bound_counts;       // количество значений, записанных в привязанные поля
+    UnknownOptionHandler unknown_option_handler; // обработчик аргументов с неизвестными опциями
+    std::vector<Subcommand> subcommands;    // подкоманды
+    const Subcommand* active_subcommand = nullptr; // указанная подкоманда
+    std::unique_ptr<ArgParser> subcommand_parser;  // парсер указанной подкоманды
 };
 
 } // namespace ArgumentParser
\ No newline at end of file
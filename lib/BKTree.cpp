@@ -0,0 +1,103 @@
+#include "BKTree.h"
+
+#include <algorithm>
+
+namespace ArgumentParser
+{
+
+void BKTree::Build(const std::vector<std::string_view>& words)
+{
+    nodes.clear();
+    word_count = words.size();
+    for (const auto word: words)
+    {
+        if (nodes.empty()) // первое слово - корень
+        {
+            nodes.push_back({word, {}});
+            continue;
+        }
+
+        uint32_t node = 0;
+        while (true) // спускаемся по ребру с расстоянием до слова текущего узла
+        {
+            const auto limit = std::max(word.size(), nodes[node].word.size());
+            const auto dist = static_cast<uint32_t>(Distance(word, nodes[node].word, limit));
+            if (dist == 0) // повтор слова
+                break;
+            auto& children = nodes[node].children;
+            const auto it = std::find_if(children.begin(), children.end(), [dist](const auto& edge){
+                return edge.first == dist;
+            });
+            if (it == children.end()) // ребра нет - новый лист
+            {
+                children.emplace_back(dist, static_cast<uint32_t>(nodes.size()));
+                nodes.push_back({word, {}});
+                break;
+            }
+            node = it->second;
+        }
+    }
+}
+
+std::vector<std::string_view> BKTree::Find(std::string_view word, size_t maxDistance) const
+{
+    std::vector<std::pair<size_t, std::string_view>> found; // (расстояние, слово)
+    if (nodes.empty())
+        return {};
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty())
+    {
+        const auto& node = nodes[stack.back()];
+        stack.pop_back();
+
+        // для отбора поддеревьев нужно точное расстояние, а оно не больше длины большего слова
+        const auto dist = Distance(word, node.word, std::max(word.size(), node.word.size()));
+        if (dist <= maxDistance)
+            found.emplace_back(dist, node.word);
+
+        for (const auto& [edge, child]: node.children)
+        {
+            if (edge + maxDistance >= dist && edge <= dist + maxDistance)
+                stack.push_back(child);
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    std::vector<std::string_view> result;
+    result.reserve(found.size());
+    for (const auto& item: found)
+        result.push_back(item.second);
+    return result;
+}
+
+size_t BKTree::Distance(std::string_view lhs, std::string_view rhs, size_t limit)
+{
+    if (lhs.size() < rhs.size()) // строка короче - по столбцам
+        std::swap(lhs, rhs);
+    if (lhs.size() - rhs.size() > limit) // разница длин уже больше предела
+        return limit + 1;
+
+    std::vector<size_t> row(rhs.size() + 1);
+    for (size_t j = 0; j <= rhs.size(); ++j)
+        row[j] = j;
+
+    for (size_t i = 1; i <= lhs.size(); ++i)
+    {
+        size_t diagonal = row[0];
+        row[0] = i;
+        size_t rowMin = row[0];
+        for (size_t j = 1; j <= rhs.size(); ++j)
+        {
+            const size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (lhs[i - 1] == rhs[j - 1] ? 0 : 1)});
+            diagonal = above;
+            rowMin = std::min(rowMin, row[j]);
+        }
+        if (rowMin > limit) // дальше расстояние только растет
+            return limit + 1;
+    }
+    return std::min(row[rhs.size()], limit + 1);
+}
+
+}
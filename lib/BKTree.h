@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// BK-дерево слов по расстоянию Левенштейна.
+// Строится один раз; поиск слов на расстоянии не больше d обходит только поддеревья,
+// ребра которых лежат в [dist - d, dist + d] (неравенство треугольника), а не весь словарь.
+class BKTree
+{
+public:
+    // Построить дерево по словам (представления должны жить дольше дерева)
+    void Build(const std::vector<std::string_view>& words);
+
+    // Слова на расстоянии не больше maxDistance от word, по возрастанию расстояния
+    std::vector<std::string_view> Find(std::string_view word, size_t maxDistance) const;
+
+    // Количество слов в дереве
+    size_t Size() const { return word_count; }
+
+    // Расстояние Левенштейна между lhs и rhs; если оно больше limit, возвращается limit + 1
+    static size_t Distance(std::string_view lhs, std::string_view rhs, size_t limit);
+
+private:
+    struct Node
+    {
+        std::string_view word;                               // слово узла
+        std::vector<std::pair<uint32_t, uint32_t>> children; // (расстояние, дочерний узел)
+    };
+
+    std::vector<Node> nodes;    // узлы (корень - нулевой)
+    size_t word_count = 0;      // количество слов
+};
+
+}
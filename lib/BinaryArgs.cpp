@@ -0,0 +1,53 @@
+#include "BinaryArgs.h"
+
+#include <cstring>
+
+namespace ArgumentParser
+{
+
+BinaryArgsWriter::BinaryArgsWriter()
+{
+    for (const char c: BinaryArgsMagic)
+        data.push_back(static_cast<std::byte>(c));
+}
+
+void BinaryArgsWriter::WriteValue(bool value)
+{
+    StoreLittleEndian<uint32_t>(data, 1);
+    data.push_back(static_cast<std::byte>(value ? 1 : 0));
+}
+
+void BinaryArgsWriter::WriteValue(int value)
+{
+    StoreLittleEndian<uint32_t>(data, sizeof(int32_t));
+    StoreLittleEndian(data, static_cast<int32_t>(value));
+}
+
+void BinaryArgsWriter::WriteValue(double value)
+{
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    StoreLittleEndian<uint32_t>(data, sizeof(bits));
+    StoreLittleEndian(data, bits);
+}
+
+void BinaryArgsWriter::WriteValue(uint64_t value)
+{
+    StoreLittleEndian<uint32_t>(data, sizeof(value));
+    StoreLittleEndian(data, value);
+}
+
+void BinaryArgsWriter::WriteValue(std::chrono::nanoseconds value)
+{
+    StoreLittleEndian<uint32_t>(data, sizeof(int64_t));
+    StoreLittleEndian(data, static_cast<int64_t>(value.count()));
+}
+
+void BinaryArgsWriter::WriteBytes(std::string_view bytes)
+{
+    StoreLittleEndian(data, static_cast<uint32_t>(bytes.size()));
+    const auto* begin = reinterpret_cast<const std::byte*>(bytes.data());
+    data.insert(data.end(), begin, begin + bytes.size());
+}
+
+}
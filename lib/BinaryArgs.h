@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Двоичный формат аргументов для запуска одного процесса другим без текстовой командной строки
+// (ArgParser::ParseBinary). Все целые - little-endian:
+//   "APB1"                                     - сигнатура
+//   записи до конца данных:
+//     uint32 ключ                              - номер опции (ArgParser::OptionId) или BinaryNameKey,
+//     [uint32 длина имени, имя]                  тогда за ним длинное имя опции
+//     uint32 длина значения, значение          - флаг: 1 байт; целое и перечисление: int32; вещественное: double;
+//                                                размер: uint64; длительность: int64 наносекунд;
+//                                                строка, путь и пользовательский тип: байты текста
+// Одна запись - одно значение (разделитель Separator не применяется); позиционные значения - записи
+// позиционной опции.
+
+// Сигнатура двоичных аргументов
+constexpr std::string_view BinaryArgsMagic = "APB1";
+
+// Ключ записи, опция которой указана именем
+constexpr uint32_t BinaryNameKey = 0xFFFFFFFF;
+
+// Записать value в out как little-endian
+template<typename T>
+void StoreLittleEndian(std::vector<std::byte>& out, T value)
+{
+    using U = std::make_unsigned_t<T>;
+    auto bits = static_cast<U>(value);
+    for (size_t i = 0; i < sizeof(T); ++i, bits = static_cast<U>(bits >> 8))
+        out.push_back(static_cast<std::byte>(bits & 0xFF));
+}
+
+// Прочитать little-endian значение типа T из data
+template<typename T>
+T LoadLittleEndian(const std::byte* data)
+{
+    using U = std::make_unsigned_t<T>;
+    U bits = 0;
+    for (size_t i = sizeof(T); i-- > 0;)
+        bits = static_cast<U>((bits << 8) | static_cast<U>(data[i]));
+    return static_cast<T>(bits);
+}
+
+// Построение двоичных аргументов
+class BinaryArgsWriter
+{
+public:
+    BinaryArgsWriter();
+
+    // Добавить значение опции с номером id (ArgParser::OptionId): bool, int (и перечисления), double,
+    // uint64_t (размер), длительность или строка
+    template<typename T>
+    BinaryArgsWriter& Add(uint32_t id, const T& value)
+    {
+        StoreLittleEndian(data, id);
+        WriteTyped(value);
+        return *this;
+    }
+
+    // То же по длинному имени опции (имя ищется при разборе)
+    template<typename T>
+    BinaryArgsWriter& Add(std::string_view name, const T& value)
+    {
+        StoreLittleEndian(data, BinaryNameKey);
+        WriteBytes(name);
+        WriteTyped(value);
+        return *this;
+    }
+
+    // Построенные данные
+    const std::vector<std::byte>& Data() const { return data; }
+
+private:
+    template<typename T>
+    void WriteTyped(const T& value)
+    {
+        if constexpr (std::is_enum_v<T>)
+            WriteValue(static_cast<int>(value));
+        else
+            WriteValue(value);
+    }
+
+    // Записать длину и значение
+    void WriteValue(bool value);
+    void WriteValue(int value);
+    void WriteValue(double value);
+    void WriteValue(uint64_t value);
+    void WriteValue(std::chrono::nanoseconds value);
+    void WriteValue(std::string_view value) { WriteBytes(value); }
+    void WriteValue(const char* value) { WriteBytes(value); }
+
+    // Записать длину и байты bytes
+    void WriteBytes(std::string_view bytes);
+
+private:
+    std::vector<std::byte> data; // построенные данные
+};
+
+}
@@ -1,10 +1,22 @@
 #include "CommandLineOption.h"
+#include "PathChecker.h"
+#include "SpillStorage.h"
+#include "Units.h"
 
+#include <algorithm>
 #include <ostream>
 
 namespace ArgumentParser
 {
 
+namespace
+{
+    template<typename T>
+    struct IsVector : std::false_type {};
+    template<typename T>
+    struct IsVector<std::vector<T>> : std::true_type {};
+}
+
 CommandLineOption::CommandLineOption(OptionType optionType, char shortOpt, std::string longOpt, std::string desc)
         : option_type(optionType)
         , short_opt(shortOpt)
@@ -27,7 +39,12 @@ CommandLineOption& CommandLineOption::Default(bool value)
 
 CommandLineOption& CommandLineOption::Default(int value)
 {
-    if (option_type != OptionType::IntegerOption) // опция должна быть целым числом
+    // целое подходит и вещественному, и (неотрицательное) размеру
+    if (option_type == OptionType::DoubleOption)
+        return Default(static_cast<double>(value));
+    if (option_type == OptionType::SizeOption && value >= 0)
+        return Default(static_cast<uint64_t>(value));
+    if (!StoresInt()) // опция должна быть целым числом (или перечислением)
         throw std::logic_error("Option is not an Integer");
     default_value = value; // устанавливаем значение по умолчанию
     return *this;
@@ -35,35 +52,115 @@ CommandLineOption& CommandLineOption::Default(int value)
 
 CommandLineOption& CommandLineOption::Default(std::string value)
 {
-    if (option_type != OptionType::StringOption) // опция должна быть строкой
+    if (!StoresString()) // опция должна быть строкой
         throw std::logic_error("Option is not a String");
     default_value.emplace<std::string>(std::move(value)); // устанавливаем значение по умолчанию
     return *this;
 }
 
+template<typename T>
+CommandLineOption& CommandLineOption::SetDefault(OptionType type, T value)
+{
+    if (option_type != type)
+        throw std::logic_error("Option " + long_opt + " has another type");
+    default_value = value;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::Default(double value)
+{
+    return SetDefault(OptionType::DoubleOption, value);
+}
+
+CommandLineOption& CommandLineOption::Default(uint64_t value)
+{
+    return SetDefault(OptionType::SizeOption, value);
+}
+
+CommandLineOption& CommandLineOption::Default(Duration value)
+{
+    return SetDefault(OptionType::DurationOption, value);
+}
+
 CommandLineOption& CommandLineOption::MultiValue(size_t minArgsCount)
 {
     is_multi_value = true;
     min_args_count = minArgsCount;
     // MultiValue имеет значение для чисел и строк, флаги не могут быть MultiValue
-    if (option_type == OptionType::IntegerOption)
+    if (StoresInt())
         argument_values.emplace<ArrayType>(Vec<int>{});
-    else if (option_type == OptionType::StringOption)
+    else if (StoresString())
         argument_values.emplace<ArrayType>(Vec<std::string>{});
-    else
+    else if (option_type == OptionType::DoubleOption)
+        argument_values.emplace<ArrayType>(Vec<double>{});
+    else if (option_type == OptionType::SizeOption)
+        argument_values.emplace<ArrayType>(Vec<uint64_t>{});
+    else if (option_type == OptionType::DurationOption)
+        argument_values.emplace<ArrayType>(Vec<Duration>{});
+    else if (option_type != OptionType::CustomOption) // пользовательские значения хранятся отдельно (custom_values)
         throw std::logic_error("Option can not be MultiValue");
     return *this;
 }
 
 CommandLineOption& CommandLineOption::Positional()
 {
-    // Позиционными аргументами могут быть только числа и строки
-    if (option_type != OptionType::IntegerOption && option_type != OptionType::StringOption)
+    // Позиционными аргументами не могут быть флаги и справка
+    if (option_type == OptionType::FlagOption || option_type == OptionType::HelpOption)
         throw std::logic_error("Option can not be Positional");
     is_positional = true;
     return *this;
 }
 
+CommandLineOption& CommandLineOption::Choices(const std::vector<std::pair<std::string_view, int>>& list)
+{
+    if (option_type != OptionType::EnumOption)
+        throw std::logic_error("Option is not an Enum");
+    auto table = std::make_shared<EnumChoices>();
+    std::vector<std::string_view> names;
+    names.reserve(list.size());
+    for (const auto& [name, value]: list)
+    {
+        names.push_back(name);
+        table->values.push_back(value);
+    }
+    table->names.Build(names); // функция строится один раз; копии опции (снимки) разделяют ее
+    choices = std::move(table);
+    return *this;
+}
+
+const int* CommandLineOption::FindChoice(std::string_view name) const
+{
+    if (!choices)
+        return nullptr;
+    const auto id = choices->names.Find(name);
+    return id == PerfectHash::NoKey ? nullptr : &choices->values[id];
+}
+
+std::string_view CommandLineOption::GetChoiceName(int value) const
+{
+    if (!choices)
+        return {};
+    const auto& values = choices->values; // используется только для справки - линейного поиска достаточно
+    const auto it = std::find(values.begin(), values.end(), value);
+    return it == values.end() ? std::string_view{} : std::string_view{choices->names.Key(static_cast<uint32_t>(it - values.begin()))};
+}
+
+std::vector<std::string_view> CommandLineOption::GetChoiceNames() const
+{
+    std::vector<std::string_view> names;
+    for (uint32_t i = 0; choices && i < choices->names.Size(); ++i)
+        names.emplace_back(choices->names.Key(i));
+    return names;
+}
+
+CommandLineOption& CommandLineOption::Env(std::string name)
+{
+    if (option_type == OptionType::HelpOption) // справку из окружения не запрашивают
+        throw std::logic_error("Help option can not be set from environment");
+    env_name = std::move(name);
+    return *this;
+}
+
 CommandLineOption& CommandLineOption::StoreValue(bool& ref)
 {
     if (option_type != OptionType::FlagOption)
@@ -82,30 +179,154 @@ CommandLineOption& CommandLineOption::StoreValue(int& ref)
 
 CommandLineOption& CommandLineOption::StoreValue(std::string& ref)
 {
-    if (option_type != OptionType::StringOption)
+    if (!StoresString())
         throw std::logic_error("Option is not a String");
     external_values.emplace<ValueRefType>(ref); // сохраняем ссылку на внешний объект для записи значения
     return *this;
 }
 
+template<typename T>
+CommandLineOption& CommandLineOption::SetExternal(OptionType type, T& ref)
+{
+    if (option_type != type)
+        throw std::logic_error("Option " + long_opt + " has another type");
+    if constexpr (IsVector<T>::value) // массив значений (MultiValue)
+        external_values.emplace<ArrayRefType>(ref);
+    else
+        external_values.emplace<ValueRefType>(ref);
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::StoreValue(double& ref)
+{
+    return SetExternal(OptionType::DoubleOption, ref);
+}
+
+CommandLineOption& CommandLineOption::StoreValue(uint64_t& ref)
+{
+    return SetExternal(OptionType::SizeOption, ref);
+}
+
+CommandLineOption& CommandLineOption::StoreValue(Duration& ref)
+{
+    return SetExternal(OptionType::DurationOption, ref);
+}
+
+CommandLineOption& CommandLineOption::StoreValues(std::vector<double>& ref)
+{
+    return SetExternal(OptionType::DoubleOption, ref);
+}
+
+CommandLineOption& CommandLineOption::StoreValues(std::vector<uint64_t>& ref)
+{
+    return SetExternal(OptionType::SizeOption, ref);
+}
+
+CommandLineOption& CommandLineOption::StoreValues(std::vector<Duration>& ref)
+{
+    return SetExternal(OptionType::DurationOption, ref);
+}
+
 CommandLineOption& CommandLineOption::StoreValues(std::vector<int>& ref)
 {
     if (option_type != OptionType::IntegerOption)
         throw std::logic_error("Option is not an Integer");
+    if (!spill_directory.empty()) // значения в файле - во внешний массив не копируем
+        throw std::logic_error("Option spills values to disk");
+    if (uses_ranges) // внешний массив развернул бы все отрезки
+        throw std::logic_error("Option stores values as ranges");
     external_values.emplace<ArrayRefType>(ref); // сохраняем ссылку на внешний объект-массив для записи значений
     return *this;
 }
 
 CommandLineOption& CommandLineOption::StoreValues(std::vector<std::string>& ref)
 {
-    if (option_type != OptionType::StringOption)
+    if (!StoresString())
         throw std::logic_error("Option is not a String");
     external_values.emplace<ArrayRefType>(ref); // сохраняем ссылку на внешний объект-массив для записи значений
     return *this;
 }
 
+CommandLineOption& CommandLineOption::SpillToDisk(std::string directory, size_t memoryLimit)
+{
+    if (option_type != OptionType::IntegerOption || !is_multi_value) // только для MultiValue целых
+        throw std::logic_error("Option is not a MultiValue Integer");
+    if (external_values.index() != 0)
+        throw std::logic_error("Option already has external storage");
+    if (uses_ranges) // отрезки и так компактны
+        throw std::logic_error("Option stores values as ranges");
+    spill_directory = std::move(directory);
+    spill_threshold = memoryLimit;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::Separator(char separatorChar)
+{
+    if (!is_multi_value) // несколько значений в аргументе имеют смысл только для MultiValue
+        throw std::logic_error("Option is not MultiValue");
+    if (separatorChar == 0)
+        throw std::logic_error("Separator can not be zero");
+    separator = separatorChar;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::Ranges()
+{
+    if (option_type != OptionType::IntegerOption || !is_multi_value)
+        throw std::logic_error("Option is not a MultiValue Integer");
+    if (external_values.index() != 0 || !spill_directory.empty())
+        throw std::logic_error("Option already has external storage");
+    uses_ranges = true;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::MustExist()
+{
+    if (option_type != OptionType::PathOption)
+        throw std::logic_error("Option " + long_opt + " is not a Path");
+    path_checks |= PathMustExist;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::MustBeReadable()
+{
+    if (option_type != OptionType::PathOption)
+        throw std::logic_error("Option " + long_opt + " is not a Path");
+    path_checks |= PathMustBeReadable;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::Prefetch()
+{
+    if (option_type != OptionType::PathOption)
+        throw std::logic_error("Option " + long_opt + " is not a Path");
+    path_checks |= PathPrefetch;
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::Glob(size_t maxMatches)
+{
+    if (!StoresString() || !is_multi_value) // путей может быть много - только MultiValue
+        throw std::logic_error("Option " + long_opt + " is not a MultiValue String or Path");
+    if (maxMatches == 0)
+        throw std::logic_error("Glob match limit can not be zero");
+    glob_limit = maxMatches;
+    return *this;
+}
+
+void CommandLineOption::ReserveValues(size_t count)
+{
+    if (!is_multi_value || custom_values || uses_ranges)
+        return;
+    std::visit([count](auto& values){ values.reserve(values.size() + count); }, std::get<ArrayType>(argument_values));
+    if (external_values.index() != 0)
+        std::visit([count](auto ref){ ref.get().reserve(ref.get().size() + count); }, std::get<ArrayRefType>(external_values));
+}
+
 bool CommandLineOption::HasDefault() const
 {
+    if (custom_values)
+        return custom_values->HasDefault();
     return default_value.index() != 0; // нулевой индекс при monostate (нет значения по умолчанию)
 }
 
@@ -141,7 +362,26 @@ int CommandLineOption::GetInt() const
 int CommandLineOption::GetInt(size_t pos) const
 {
     // возвращаем значение числа в позиции pos массива сохраненных значений (MultiValue)
-    return std::get<Vec<int>>(std::get<ArrayType>(argument_values)).at(pos);
+    if (uses_ranges) // значение вычисляется по отрезку, в который попадает pos
+        return intervals.Get(pos);
+    const auto& values = std::get<Vec<int>>(std::get<ArrayType>(argument_values));
+    if (spill_storage && pos >= values.size()) // первые значения в памяти, остальные - в файле
+        return spill_storage->Get(pos - values.size());
+    return values.at(pos);
+}
+
+size_t CommandLineOption::GetValuesCount() const
+{
+    if (custom_values)
+        return custom_values->Size();
+    if (!is_multi_value) // одиночное значение: есть или нет
+        return std::get<ValueType>(argument_values).index() == 0 ? 0 : 1;
+    if (uses_ranges)
+        return intervals.Size();
+    if (StoresInt()) // числа: в памяти и, возможно, в файле
+        return std::get<Vec<int>>(std::get<ArrayType>(argument_values)).size()
+            + (spill_storage ? spill_storage->Size() : 0);
+    return std::visit([](const auto& values){ return values.size(); }, std::get<ArrayType>(argument_values));
 }
 
 const std::string& CommandLineOption::GetString() const
@@ -165,18 +405,32 @@ CommandLineOption& CommandLineOption::SetValue(bool value)
     argument_values = value; // устанавливаем значение флага
     if (external_values.index() != 0) // если есть ссылка на внешнее хранилище (индекс хранимого типа не monostate)
         std::get<Ref<bool>>(std::get<ValueRefType>(external_values)).get() = value; // записываем значение в это хранилище
+    if (value_action) // сообщаем о значении сразу
+        value_action(value);
     return *this;
 }
 
 CommandLineOption& CommandLineOption::SetValue(int value)
 {
-    if (option_type != OptionType::IntegerOption)
+    if (!StoresInt())
         throw std::logic_error("Option is not an Integer");
 
     if (argument_values.index() == 0) // если храним одиночное значение (не MultiValue)
         argument_values = value; // устанавливаем его
+    else if (uses_ranges) // одиночное значение - отрезок из одного значения
+        intervals.Append(value, value);
     else // иначе (MultiValue), добавляем значение в массив
-        std::get<Vec<int>>(std::get<ArrayType>(argument_values)).push_back(value);
+    {
+        auto& values = std::get<Vec<int>>(std::get<ArrayType>(argument_values));
+        if (!spill_directory.empty() && values.size() >= spill_threshold) // в памяти больше нет места
+        {
+            if (!spill_storage) // создаем временный файл при первом переполнении
+                spill_storage = std::make_shared<SpillStorage>(spill_directory);
+            spill_storage->Append(value);
+        }
+        else
+            values.push_back(value);
+    }
 
     if (external_values.index() != 0) // если есть ссылка на внешнее хранилище (индекс хранимого типа не monostate)
     {
@@ -185,12 +439,14 @@ CommandLineOption& CommandLineOption::SetValue(int value)
         else // иначе, записываем значение по хранимой ссылке на внешнее хранилище
             std::get<Ref<int>>(std::get<ValueRefType>(external_values)).get() = value;
     }
+    if (value_action)
+        value_action(value);
     return *this;
 }
 
 CommandLineOption& CommandLineOption::SetValue(const std::string& value)
 {
-    if (option_type != OptionType::StringOption)
+    if (!StoresString())
         throw std::logic_error("Option is not a String");
 
     if (argument_values.index() == 0)
@@ -205,27 +461,109 @@ CommandLineOption& CommandLineOption::SetValue(const std::string& value)
         else
             std::get<Ref<std::string>>(std::get<ValueRefType>(external_values)).get() = value;
     }
+    if (value_action)
+        value_action(value);
+    return *this;
+}
+
+template<typename T>
+CommandLineOption& CommandLineOption::SetTyped(OptionType type, const T& value)
+{
+    if (option_type != type)
+        throw std::logic_error("Option " + long_opt + " has another type");
+
+    if (!is_multi_value)
+        std::get<ValueType>(argument_values) = value;
+    else
+        std::get<Vec<T>>(std::get<ArrayType>(argument_values)).push_back(value);
+
+    if (external_values.index() != 0)
+    {
+        if (is_multi_value)
+            std::get<Ref<Vec<T>>>(std::get<ArrayRefType>(external_values)).get().push_back(value);
+        else
+            std::get<Ref<T>>(std::get<ValueRefType>(external_values)).get() = value;
+    }
+    if (value_action)
+        value_action(value);
+    return *this;
+}
+
+CommandLineOption& CommandLineOption::SetValue(double value)
+{
+    return SetTyped(OptionType::DoubleOption, value);
+}
+
+CommandLineOption& CommandLineOption::SetValue(uint64_t value)
+{
+    return SetTyped(OptionType::SizeOption, value);
+}
+
+CommandLineOption& CommandLineOption::SetValue(Duration value)
+{
+    return SetTyped(OptionType::DurationOption, value);
+}
+
+std::errc CommandLineOption::SetCustomValue(std::string_view text)
+{
+    if (!custom_values)
+        throw std::logic_error("Option " + long_opt + " is not a custom type option");
+    return custom_values->Add(text, is_multi_value);
+}
+
+CommandLineOption& CommandLineOption::AddRange(int first, int last)
+{
+    if (!uses_ranges)
+        throw std::logic_error("Option does not accept ranges");
+    intervals.Append(first, last);
     return *this;
 }
 
 bool CommandLineOption::IsValid() const
 {
-    if (!is_multi_value && std::get<ValueType>(argument_values).index() == 0) // если не MultiValue, и нет значения (monostate)
+    if (!is_multi_value && GetValuesCount() == 0) // если не MultiValue, и нет значения (monostate)
         return HasDefault(); // возвращаем, есть ли значение по умолчанию для данной опции
 
     if (is_multi_value) // если MultiValue
     {
-        size_t count = 0; // количество сохраненных значений
-        if (option_type == OptionType::IntegerOption) // если храним числа
-            count = std::get<Vec<int>>(std::get<ArrayType>(argument_values)).size();
-        else if (option_type == OptionType::StringOption) // если строки
-            count = std::get<Vec<std::string>>(std::get<ArrayType>(argument_values)).size();
-        if (count < min_args_count) // если количество сохраненных значений меньше минимального
+        if (GetValuesCount() < min_args_count) // если количество сохраненных значений меньше минимального
             return false; // объект не корректен (нет/недостаточно обязательных значений)
     }
     return true;
 }
 
+void CommandLineOption::ClearValues()
+{
+    if (option_type == OptionType::HelpOption)
+        argument_values = false; // справка снова не запрошена
+    else if (custom_values)
+        custom_values->Clear();
+    else if (!is_multi_value)
+        argument_values = ValueType{};
+    else
+        std::visit([](auto& values){ values.clear(); }, std::get<ArrayType>(argument_values));
+    spill_storage.reset(); // старый файл остается у тех, кто еще ссылается на прежние значения
+    intervals.Clear();
+}
+
+void CommandLineOption::EraseValue(size_t pos)
+{
+    std::visit([pos](auto& values){
+        if (pos >= values.size())
+            throw std::out_of_range("Value position out of range");
+        values.erase(values.begin() + static_cast<std::ptrdiff_t>(pos));
+    }, std::get<ArrayType>(argument_values));
+}
+
+void CommandLineOption::MoveLastValue(size_t pos)
+{
+    std::visit([pos](auto& values){
+        if (pos >= values.size())
+            throw std::out_of_range("Value position out of range");
+        std::rotate(values.begin() + static_cast<std::ptrdiff_t>(pos), values.end() - 1, values.end());
+    }, std::get<ArrayType>(argument_values));
+}
+
 // формирование и вывод в поток отформатированной строки с информацией об опции в виде:
 // -<короткое_имя>,  --<длинное_имя>,  <описание> [<по_умолчанию> | <повторы>]
 // для позиционного аргумента <короткое_имя> не выводится, тире отсутствуют.
@@ -249,15 +587,31 @@ std::ostream& operator<<(std::ostream& os, const CommandLineOption& opt)
     else
     {
         os << opt.GetDescription(); // выводим описание
+        if (optionType == OptionType::EnumOption) // допустимые значения перечисления
+        {
+            os << '[';
+            const auto names = opt.GetChoiceNames();
+            for (size_t i = 0; i < names.size(); ++i)
+                os << (i ? "|" : "") << names[i];
+            os << ']';
+        }
         if (opt.IsMultiValue()) // повтор и минимальное количество раз (для MultiValue)
             os << "[repeated, min args = " << opt.GetMinArgs() << "]";
-        else if (opt.HasDefault()) // если есть значение по умолчанию
+        else if (opt.HasDefault() && optionType != OptionType::CustomOption) // если есть значение по умолчанию
         { // выводим его
             os << "[default = ";
             if (optionType == OptionType::FlagOption)
                 os << std::boolalpha << opt.GetDefaultFlag();
             else if (optionType == OptionType::IntegerOption)
                 os << opt.GetDefaultInt();
+            else if (optionType == OptionType::EnumOption)
+                os << opt.GetChoiceName(opt.GetDefaultInt());
+            else if (optionType == OptionType::DoubleOption)
+                os << opt.GetDefaultDouble();
+            else if (optionType == OptionType::SizeOption)
+                os << FormatByteSize(opt.GetDefaultSize());
+            else if (optionType == OptionType::DurationOption)
+                os << FormatDuration(opt.GetDefaultDuration());
             else
                 os << opt.GetDefaultString();
             os << "]";
@@ -1,24 +1,52 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <memory>
 #include <variant>
+#include <iterator>
 #include <utility>
 #include <functional>
 #include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "CustomValues.h"
+#include "IntervalList.h"
+#include "PerfectHash.h"
 
 namespace ArgumentParser
 {
 
+class SpillStorage;
+
 // Класс перечисления типа аргумента
 enum class OptionType
 {
     FlagOption,     // булевый аргумент (флаг)
     IntegerOption,  // целочисленный
     StringOption,   // строковой
-    HelpOption      // опция справки (помощь)
+    HelpOption,     // опция справки (помощь)
+    EnumOption,     // перечисление: одно из допустимых имен, хранится как целое
+    DoubleOption,   // вещественный
+    SizeOption,     // размер в байтах (64K, 1.5G, 2GiB)
+    DurationOption, // длительность (250ms, 3s, 1h30m)
+    PathOption,     // путь к файлу или каталогу: строка с проверками (MustExist, MustBeReadable)
+    CustomOption    // пользовательский тип со своим преобразователем (ArgParser::AddArgument<T>)
+};
+
+// Допустимые значения опции-перечисления: имя -> значение через совершенную хеш-функцию
+struct EnumChoices
+{
+    PerfectHash names;          // имена значений
+    std::vector<int> values;    // значения по номерам имен
 };
 
+template<typename T>
+class TypedOption;
+
 // Класс описывает одну опцию или аргумент командной строки
 class CommandLineOption
 {
@@ -32,22 +60,27 @@ class CommandLineOption
     template<typename T>
     using Vec = std::vector<T>;
 
+    // Длительность
+    using Duration = std::chrono::nanoseconds;
+
     // Тип значения опции/аргумента, переданной программе при ее вызове.
-    // Возможные типы: флаг(bool), целое(int) или строка(string), либо monostate, если объект еще не содержит значения.
-    using ValueType = std::variant<std::monostate, bool, int, std::string>;
+    // Возможные типы: флаг(bool), целое(int), строка(string), вещественное(double), размер(uint64_t)
+    // или длительность, либо monostate, если объект еще не содержит значения.
+    using ValueType = std::variant<std::monostate, bool, int, std::string, double, uint64_t, Duration>;
 
     // Тип массива значений опции/аргумента для случая MultiValue
-    using ArrayType = std::variant<Vec<bool>, Vec<int>, Vec<std::string>>;
+    using ArrayType = std::variant<Vec<bool>, Vec<int>, Vec<std::string>, Vec<double>, Vec<uint64_t>, Vec<Duration>>;
 
     // Тип хранимого в объекте CommandLineOption значения опции/аргумента.
     // В зависимости является ли объект MultiValue, хранит значение или массив значений.
     using ArgumentStorageType = std::variant<ValueType, ArrayType>;
 
     // Тип значения для хранения ссылки на внешний объект, куда сохраняется значение опции объекта.
-    using ValueRefType = std::variant<Ref<bool>, Ref<int>, Ref<std::string>>;
+    using ValueRefType = std::variant<Ref<bool>, Ref<int>, Ref<std::string>, Ref<double>, Ref<uint64_t>, Ref<Duration>>;
 
     // Тип значения для хранения ссылки на внешний массив объектов, куда сохраняются значения опции объекта (MultiValue).
-    using ArrayRefType = std::variant<Ref<Vec<bool>>, Ref<Vec<int>>, Ref<Vec<std::string>>>;
+    using ArrayRefType = std::variant<Ref<Vec<bool>>, Ref<Vec<int>>, Ref<Vec<std::string>>,
+                                      Ref<Vec<double>>, Ref<Vec<uint64_t>>, Ref<Vec<Duration>>>;
 
     // Тип хранимого в объекте CommandLineOption ссылки на внешнее хранилище значений опции/аргумента.
     // В зависимости является ли объект MultiValue, хранит ссылку на объект или массив объектов (MultiValue),
@@ -69,12 +102,31 @@ public:
     // перегрузка для устранения неопределенности с bool версией.
     CommandLineOption& Default(const char* value) { return Default(std::string{value}); }
 
+    // Установить значение по умолчанию для вещественного
+    CommandLineOption& Default(double value);
+
+    // Установить значение по умолчанию для размера
+    CommandLineOption& Default(uint64_t value);
+
+    // Установить значение по умолчанию для длительности
+    CommandLineOption& Default(Duration value);
+
+    // Установить значение по умолчанию для перечисления
+    template<typename E, typename = std::enable_if_t<std::is_enum_v<E>>>
+    CommandLineOption& Default(E value) { return Default(static_cast<int>(value)); }
+
+    // Задать допустимые значения перечисления: пары (имя, значение)
+    CommandLineOption& Choices(const std::vector<std::pair<std::string_view, int>>& choices);
+
     // Установить, что опция будет иметь несколько значений (минимум minArgsCount)
     CommandLineOption& MultiValue(size_t minArgsCount = 0);
 
     // Установить, что текущий объект - позиционный аргумент
     CommandLineOption& Positional();
 
+    // Брать значение из переменной окружения name, если опция не указана в командной строке
+    CommandLineOption& Env(std::string name);
+
     // Указать внешний объект для сохранения значения опции
     CommandLineOption& StoreValue(bool& ref);
 
@@ -84,9 +136,19 @@ public:
     // Указать внешний объект для сохранения значения опции/аргумента
     CommandLineOption& StoreValue(std::string& ref);
 
+    // Указать внешний объект для сохранения значения опции/аргумента (вещественное, размер, длительность)
+    CommandLineOption& StoreValue(double& ref);
+    CommandLineOption& StoreValue(uint64_t& ref);
+    CommandLineOption& StoreValue(Duration& ref);
+
     // Указать внешний объект для сохранения массива значений опции/аргумента
     CommandLineOption& StoreValues(std::vector<int>& ref);
 
+    // То же для вещественных, размеров и длительностей
+    CommandLineOption& StoreValues(std::vector<double>& ref);
+    CommandLineOption& StoreValues(std::vector<uint64_t>& ref);
+    CommandLineOption& StoreValues(std::vector<Duration>& ref);
+
     // Указать внешний объект для сохранения массива значений опции/аргумента
     CommandLineOption& StoreValues(std::vector<std::string>& ref);
 
@@ -96,6 +158,66 @@ public:
     CommandLineOption& StoreValue(std::vector<int>& ref) { return StoreValues(ref); }
     CommandLineOption& StoreValue(std::vector<std::string>& ref) { return StoreValues(ref); }
 
+    // Вызывать action(значение) сразу при установке каждого значения опции (из командной строки, окружения
+    // или конфигурации; не для значения по умолчанию). Тип аргумента - тип опции: bool, int (и перечисления),
+    // std::string, double, uint64_t (размер) или длительность. Для отрезков (Ranges) не вызывается.
+    template<typename F>
+    CommandLineOption& Action(F action)
+    {
+        switch (option_type)
+        {
+            case OptionType::FlagOption: return SetAction<bool>(std::move(action));
+            case OptionType::IntegerOption:
+            case OptionType::EnumOption: return SetAction<int>(std::move(action));
+            case OptionType::StringOption:
+            case OptionType::PathOption: return SetAction<std::string>(std::move(action));
+            case OptionType::DoubleOption: return SetAction<double>(std::move(action));
+            case OptionType::SizeOption: return SetAction<uint64_t>(std::move(action));
+            case OptionType::DurationOption: return SetAction<Duration>(std::move(action));
+            default: throw std::logic_error("Option can not have an action");
+        }
+    }
+
+    // Задано ли действие (Action)
+    bool HasAction() const { return static_cast<bool>(value_action); }
+
+    // Хранить значения сверх memoryLimit во временном файле в каталоге directory (только MultiValue целые).
+    // Несовместимо с внешним хранилищем: весь смысл в том, чтобы не держать значения в памяти.
+    CommandLineOption& SpillToDisk(std::string directory, size_t memoryLimit);
+
+    // Разрешить для MultiValue опции несколько значений в одном аргументе через separator: --param1=1,2,3
+    CommandLineOption& Separator(char separator = ',');
+
+    // Разделитель значений в одном аргументе (0 - не задан)
+    char GetSeparator() const { return separator; }
+
+    // Разрешить для MultiValue целых списки и диапазоны в одном значении: --ids=1,5,9-100000.
+    // Значения хранятся отрезками и не разворачиваются; несовместимо с StoreValues и SpillToDisk.
+    CommandLineOption& Ranges();
+
+    // Проверять, что путь существует (только опции-пути; проверки идут в фоне во время разбора)
+    CommandLineOption& MustExist();
+
+    // Проверять, что путь доступен для чтения (только опции-пути)
+    CommandLineOption& MustBeReadable();
+
+    // Открывать файл сразу при установке значения (в фоне) и просить ядро прочитать его в кэш (только опции-пути).
+    // Дескрипторы - ArgParser::GetFileDescriptor; не открывшийся файл - дескриптор -1, а не ошибка разбора.
+    CommandLineOption& Prefetch();
+
+    // Разворачивать значения-шаблоны (*, ?, [...]) в существующие пути прямо во время разбора
+    // (MultiValue строки и пути). Если путей больше maxMatches - ошибка разбора; без совпадений шаблон остается как есть.
+    CommandLineOption& Glob(size_t maxMatches = 100000);
+
+    // Наибольшее число путей одного шаблона (0 - шаблоны не разворачиваются)
+    size_t GetGlobLimit() const { return glob_limit; }
+
+    // Подготовить место еще для count значений (MultiValue), в том числе во внешнем массиве
+    void ReserveValues(size_t count);
+
+    // Проверки пути (маска PathCheck; 0 - нет проверок)
+    uint8_t GetPathChecks() const { return path_checks; }
+
     // Определено ли значение по умолчанию для данной опции
     bool HasDefault() const;
 
@@ -108,6 +230,20 @@ public:
     // Получить значение по умолчанию для строки
     const std::string& GetDefaultString() const;
 
+    // Получить значение по умолчанию для вещественного, размера и длительности
+    double GetDefaultDouble() const { return std::get<double>(default_value); }
+    uint64_t GetDefaultSize() const { return std::get<uint64_t>(default_value); }
+    Duration GetDefaultDuration() const { return std::get<Duration>(default_value); }
+
+    // Значение перечисления по имени name (nullptr, если такого имени нет)
+    const int* FindChoice(std::string_view name) const;
+
+    // Имя значения перечисления value (пусто, если такого значения нет)
+    std::string_view GetChoiceName(int value) const;
+
+    // Все имена значений перечисления в порядке добавления
+    std::vector<std::string_view> GetChoiceNames() const;
+
     // Получить значение флага
     bool GetFlag() const;
 
@@ -117,12 +253,23 @@ public:
     // Получить значение целого из массива значений в позиции pos (MultiValue)
     int GetInt(size_t pos) const;
 
+    // Количество сохраненных значений (MultiValue)
+    size_t GetValuesCount() const;
+
     // Получить значение строки
     const std::string& GetString() const;
 
     // Получить значение строки из массива значений в позиции pos (MultiValue)
     const std::string& GetString(size_t pos) const;
 
+    // Получить значение вещественного, размера или длительности (и в позиции pos для MultiValue)
+    double GetDouble() const { return GetTyped<double>(); }
+    double GetDouble(size_t pos) const { return GetTyped<double>(pos); }
+    uint64_t GetSize() const { return GetTyped<uint64_t>(); }
+    uint64_t GetSize(size_t pos) const { return GetTyped<uint64_t>(pos); }
+    Duration GetDuration() const { return GetTyped<Duration>(); }
+    Duration GetDuration(size_t pos) const { return GetTyped<Duration>(pos); }
+
     // Установить значение флага
     CommandLineOption& SetValue(bool value);
 
@@ -132,6 +279,21 @@ public:
     // Установить или добавить (для MultiValue) значение строки
     CommandLineOption& SetValue(const std::string& value);
 
+    // Добавить значения first, first + 1, ..., last (Ranges)
+    CommandLineOption& AddRange(int first, int last);
+
+    // Установить или добавить (для MultiValue) вещественное, размер или длительность
+    CommandLineOption& SetValue(double value);
+    CommandLineOption& SetValue(uint64_t value);
+    CommandLineOption& SetValue(Duration value);
+
+    // Преобразовать text в значение пользовательского типа и сохранить; код ошибки преобразователя
+    std::errc SetCustomValue(std::string_view text);
+
+    // Значение пользовательского типа T (и в позиции pos для MultiValue)
+    template<typename T>
+    const T& GetCustom(size_t pos = 0) const { return Typed<T>().Get(pos); }
+
     // Позиционный ли аргумент
     bool IsPositional() const { return is_positional; }
 
@@ -153,20 +315,211 @@ public:
     // Описание опции
     const std::string& GetDescription() const { return description; }
 
+    // Имя переменной окружения со значением опции (пусто - не задано)
+    const std::string& GetEnv() const { return env_name; }
+
     // Проверка на корректность объекта опции
     bool IsValid() const;
 
+    // Сбросить сохраненные значения (перед повторным разбором); внешнее хранилище не затрагивается
+    void ClearValues();
+
+    // Удалить значение в позиции pos (MultiValue)
+    void EraseValue(size_t pos);
+
+    // Переместить последнее значение в позицию pos, сдвинув остальные (MultiValue)
+    void MoveLastValue(size_t pos);
+
+    // Указано ли внешнее хранилище (StoreValue, StoreValues)
+    bool HasExternalStorage() const { return external_values.index() != 0; }
+
+    // Отвязать внешнее хранилище и действие (у снимков опций, которые не должны влиять на программу)
+    void DetachExternalStorage()
+    {
+        external_values = std::monostate{};
+        value_action = nullptr;
+    }
+
+    // Переносятся ли значения во временный файл
+    bool SpillsToDisk() const { return !spill_directory.empty(); }
+
+    // Хранятся ли значения отрезками (Ranges)
+    bool UsesRanges() const { return uses_ranges; }
+    // Значения, записанные отрезками (Ranges)
+    const IntervalList& GetIntervals() const { return intervals; }
+
+private:
+    template<typename T>
+    friend class TypedOption;
+
+    // Хранилище значений пользовательского типа T (создается при первом обращении)
+    template<typename T>
+    TypedValues<T>& Typed()
+    {
+        if (option_type != OptionType::CustomOption)
+            throw std::logic_error("Option " + long_opt + " is not a custom type option");
+        if (!custom_values)
+            custom_values = CustomValuesPtr(std::make_unique<TypedValues<T>>());
+        return const_cast<TypedValues<T>&>(std::as_const(*this).Typed<T>());
+    }
+
+    template<typename T>
+    const TypedValues<T>& Typed() const
+    {
+        const auto* values = dynamic_cast<const TypedValues<T>*>(custom_values.get());
+        if (!values)
+            throw std::logic_error("Option " + long_opt + " has another type");
+        return *values;
+    }
+
+    // Значение типа T (или значение по умолчанию, если значения нет)
+    template<typename T>
+    const T& GetTyped() const
+    {
+        const auto& value = std::get<ValueType>(argument_values);
+        return value.index() == 0 ? std::get<T>(default_value) : std::get<T>(value);
+    }
+
+    // Значение типа T в позиции pos (MultiValue)
+    template<typename T>
+    const T& GetTyped(size_t pos) const { return std::get<Vec<T>>(std::get<ArrayType>(argument_values)).at(pos); }
+
+    // Запомнить действие, принимающее значение типа T
+    template<typename T, typename F>
+    CommandLineOption& SetAction(F action)
+    {
+        if constexpr (std::is_invocable_v<F&, const T&>)
+        {
+            value_action = [action = std::move(action)](const ValueType& value) mutable { action(std::get<T>(value)); };
+            return *this;
+        }
+        else
+            throw std::logic_error("Action does not accept value of option " + long_opt);
+    }
+
+    // Проверить тип опции и установить значение по умолчанию
+    template<typename T>
+    CommandLineOption& SetDefault(OptionType type, T value);
+
+    // Проверить тип опции и запомнить ссылку на внешнее хранилище (значение или массив)
+    template<typename T>
+    CommandLineOption& SetExternal(OptionType type, T& ref);
+
+    // Проверить тип опции, установить или добавить значение и записать его во внешнее хранилище
+    template<typename T>
+    CommandLineOption& SetTyped(OptionType type, const T& value);
+
+    // Хранится ли значение как строка (строки и пути)
+    bool StoresString() const { return option_type == OptionType::StringOption || option_type == OptionType::PathOption; }
+
+    // Хранится ли значение как целое (целые и перечисления)
+    bool StoresInt() const { return option_type == OptionType::IntegerOption || option_type == OptionType::EnumOption; }
+
 private:
     OptionType option_type;                 // Тип данной опции
     const char short_opt;                   // Короткая опция
     const std::string long_opt;             // Длинная опция
     const std::string description;          // Описание
+    std::string env_name;                   // Переменная окружения со значением опции
     ValueType default_value;                // Значение по умолчанию
     ArgumentStorageType argument_values;    // Хранимое значение (значение или массив значений для MultiValue)
     ExternalStorageType external_values;    // Ссылка на внешнее значение (значение или массив значений для MultiValue)
     bool is_positional = false;             // Позиционный ли аргумент
     bool is_multi_value = false;            // Хранит ли множество значений (MultiValue)
     size_t min_args_count = 0;              // Минимальное количество значений (для MultiValue)
+    std::string spill_directory;            // Каталог для временного файла значений (пусто - не используется)
+    size_t spill_threshold = 0;             // Сколько значений хранить в памяти до переноса в файл
+    std::shared_ptr<SpillStorage> spill_storage; // Значения, перенесенные в файл (создается при превышении порога)
+    std::shared_ptr<const EnumChoices> choices;  // Допустимые значения перечисления (общие для копий опции)
+    std::function<void(const ValueType&)> value_action; // Действие при установке значения (Action)
+    char separator = 0;                     // Разделитель значений в одном аргументе (0 - не задан)
+    bool uses_ranges = false;               // Хранятся ли значения отрезками (Ranges)
+    IntervalList intervals;                 // Значения, записанные отрезками
+    CustomValuesPtr custom_values;          // Значения пользовательского типа (CustomOption)
+    uint8_t path_checks = 0;                // Проверки пути (PathCheck)
+    size_t glob_limit = 0;                  // Наибольшее число путей шаблона (0 - шаблоны не разворачиваются)
+};
+
+// Настройка опции пользовательского типа T: значение по умолчанию и преобразователь текста в T.
+// Значения хранятся в самой опции уже преобразованными; T должен иметь конструктор по умолчанию и копироваться.
+template<typename T>
+class TypedOption
+{
+public:
+    explicit TypedOption(CommandLineOption& option) : option(option) { option.Typed<T>(); }
+
+    // Установить значение по умолчанию
+    TypedOption& Default(T value)
+    {
+        option.Typed<T>().default_value = std::move(value);
+        return *this;
+    }
+
+    // Задать преобразователь: converter(текст, значение) возвращает std::errc{} при успехе или код ошибки,
+    // который попадает в ошибку разбора (исключения из преобразователя не ожидаются)
+    CommandLineOption& Converter(typename TypedValues<T>::ConverterType converter)
+    {
+        if (!converter)
+            throw std::logic_error("Converter of option " + option.GetLongOption() + " is empty");
+        option.Typed<T>().converter = std::move(converter);
+        return option;
+    }
+
+private:
+    CommandLineOption& option; // настраиваемая опция
+};
+
+// Диапазон целых значений MultiValue опции для обхода в цикле for.
+// Значения читаются по позиции, поэтому обход работает и для значений, перенесенных в файл.
+// Отрезки (Ranges) разворачиваются последовательно: итератор помнит текущий отрезок, шаг - O(1).
+class IntValues
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = int;
+
+        Iterator(const CommandLineOption& option, size_t pos)
+            : option(&option), pos(pos), interval(option.UsesRanges() ? option.GetIntervals().FindInterval(pos) : 0) {}
+
+        int operator*() const
+        {
+            if (!option->UsesRanges())
+                return option->GetInt(pos);
+            const auto& intervals = option->GetIntervals();
+            return static_cast<int>(static_cast<int64_t>(intervals.First(interval))
+                                    + static_cast<int64_t>(pos - intervals.Start(interval)));
+        }
+        Iterator& operator++()
+        {
+            ++pos;
+            if (option->UsesRanges() && pos == option->GetIntervals().End(interval)) // отрезок закончился
+                ++interval;
+            return *this;
+        }
+        Iterator operator++(int) { auto tmp = *this; ++*this; return tmp; }
+        bool operator==(const Iterator& other) const { return pos == other.pos; }
+        bool operator!=(const Iterator& other) const { return pos != other.pos; }
+
+    private:
+        const CommandLineOption* option; // опция, значения которой обходим
+        size_t pos;                      // текущая позиция
+        size_t interval;                 // отрезок, в который попадает pos (для Ranges)
+    };
+
+    explicit IntValues(const CommandLineOption& option) : option(option) {}
+
+    Iterator begin() const { return {option, 0}; }
+    Iterator end() const { return {option, option.GetValuesCount()}; }
+    size_t size() const { return option.GetValuesCount(); }
+
+private:
+    const CommandLineOption& option;
 };
 
 // Оператор вывода опции в поток. Выводит информацию о ней:
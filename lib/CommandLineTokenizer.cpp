@@ -0,0 +1,133 @@
+#include "CommandLineTokenizer.h"
+#include "SimdScan.h"
+
+#include <cstring>
+
+namespace ArgumentParser
+{
+
+namespace
+{
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+}
+
+bool CommandLineTokenizer::Split(std::string_view line, std::vector<std::string_view>& tokens)
+{
+    const char* pos = line.data();
+    const char* const end = pos + line.size();
+    std::string pending; // аргумент, который не получается взять представлением
+
+    while (true)
+    {
+        // пропускаем разделители и продолжения строки ('\' + перевод строки) перед аргументом
+        while (pos != end && (IsSpace(*pos) || (*pos == '\\' && pos + 1 != end && pos[1] == '\n')))
+            pos += IsSpace(*pos) ? 1 : 2;
+        if (pos == end)
+            return true;
+
+        const char* const start = pos;
+        bool copied = false; // собирается ли аргумент в pending
+        const auto startCopy = [&](const char* upTo) { // переход к сборке: уже пройденная часть аргумента
+            if (!copied)
+                pending.assign(start, upTo);
+            copied = true;
+        };
+
+        while (true)
+        {
+            // до ближайшего разделителя, кавычки или '\' обычные символы - пропускаем их блоками
+            const char* special = FindAnyOf(pos, end, ' ', '\t', '\n', '\r', '\'', '"', '\\');
+            if (copied)
+                pending.append(pos, special);
+            pos = special;
+
+            if (pos == end || IsSpace(*pos)) // конец аргумента
+            {
+                tokens.push_back(copied ? Store(pending) : std::string_view(start, pos - start));
+                break;
+            }
+
+            if (*pos == '\\') // экранирование следующего символа
+            {
+                startCopy(pos);
+                if (pos + 1 == end) // '\' в конце строки - обычный символ
+                {
+                    pending.push_back('\\');
+                    ++pos;
+                }
+                else
+                {
+                    if (pos[1] != '\n') // '\' + перевод строки - продолжение строки
+                        pending.push_back(pos[1]);
+                    pos += 2;
+                }
+                continue;
+            }
+
+            const char quote = *pos;
+            const char* close = pos + 1;
+            if (quote == '\'') // в одинарных кавычках экранирования нет
+                close = FindAnyOf(close, end, '\'');
+            else // в двойных - только \" \\ \$ \` и перевод строки
+            {
+                while ((close = FindAnyOf(close, end, '"', '\\')) != end && *close == '\\')
+                {
+                    startCopy(pos);
+                    close += close + 1 == end ? 1 : 2;
+                }
+            }
+            if (close == end) // кавычка не закрыта
+                return false;
+
+            // аргумент целиком в кавычках и без экранирования - берем представление на содержимое
+            if (!copied && pos == start && (close + 1 == end || IsSpace(close[1])))
+            {
+                tokens.emplace_back(pos + 1, close - pos - 1);
+                pos = close + 1;
+                break;
+            }
+
+            startCopy(pos);
+            for (const char* c = pos + 1; c != close; ++c)
+            {
+                if (quote == '"' && *c == '\\' && c + 1 != close &&
+                    (c[1] == '"' || c[1] == '\\' || c[1] == '$' || c[1] == '`' || c[1] == '\n'))
+                {
+                    ++c;
+                    if (*c == '\n') // продолжение строки
+                        continue;
+                }
+                pending.push_back(*c);
+            }
+            pos = close + 1;
+        }
+    }
+}
+
+std::string_view CommandLineTokenizer::Store(const std::string& token)
+{
+    if (token.empty()) // пустой аргумент ('' или ""): буфер не нужен
+        return {};
+    if (token.size() > BlockSize) // большой аргумент - в отдельном блоке своего размера
+    {
+        auto block = std::make_unique<char[]>(token.size());
+        std::memcpy(block.get(), token.data(), token.size());
+        const std::string_view view(block.get(), token.size());
+        blocks.insert(blocks.begin(), std::move(block)); // текущим остается последний блок
+        return view;
+    }
+    if (BlockSize - block_used < token.size()) // в текущем блоке не хватает места
+    {
+        blocks.push_back(std::make_unique<char[]>(BlockSize));
+        block_used = 0;
+    }
+    char* dest = blocks.back().get() + block_used;
+    std::memcpy(dest, token.data(), token.size());
+    block_used += token.size();
+    return {dest, token.size()};
+}
+
+}
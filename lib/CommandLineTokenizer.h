@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Разбиение строки командной строки на аргументы по правилам POSIX shell:
+// пробельные символы разделяют аргументы, '...' - без экранирования, "..." - с экранированием \" \\ \$ \`,
+// вне кавычек \ экранирует следующий символ.
+// Аргументы без экранирования и склеек - представления внутри исходной строки; остальные собираются
+// в небольшой внутренний буфер токенизатора. Представления действительны, пока жив токенизатор.
+class CommandLineTokenizer
+{
+public:
+    // Разбить line на аргументы и добавить их в tokens. Возвращает false при незакрытой кавычке.
+    bool Split(std::string_view line, std::vector<std::string_view>& tokens);
+
+private:
+    // Сохранить собранный аргумент в буфере и вернуть представление на него
+    std::string_view Store(const std::string& token);
+
+private:
+    static constexpr size_t BlockSize = 4096;       // размер блока буфера
+
+    std::vector<std::unique_ptr<char[]>> blocks;    // блоки буфера (не перемещаются - представления остаются действительными)
+    size_t block_used = BlockSize;                  // занято в последнем блоке
+};
+
+}
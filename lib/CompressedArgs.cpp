@@ -0,0 +1,173 @@
+#include "CompressedArgs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef ARGPARSER_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef ARGPARSER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ArgumentParser
+{
+
+namespace
+{
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+}
+
+Compression DetectCompression(std::string_view data)
+{
+    if (data.size() >= 2 && data[0] == '\x1f' && data[1] == '\x8b')
+        return Compression::Gzip;
+    if (data.size() >= 4 && data.substr(0, 4) == std::string_view("\x28\xb5\x2f\xfd", 4))
+        return Compression::Zstd;
+    return Compression::None;
+}
+
+bool SupportsCompression(Compression compression)
+{
+    switch (compression)
+    {
+        case Compression::None: return true;
+#ifdef ARGPARSER_WITH_ZLIB
+        case Compression::Gzip: return true;
+#endif
+#ifdef ARGPARSER_WITH_ZSTD
+        case Compression::Zstd: return true;
+#endif
+        default: return false;
+    }
+}
+
+void CompressedArgs::Split(std::string_view data, std::vector<std::string_view>& args)
+{
+    const auto compression = DetectCompression(data);
+    if (compression == Compression::None || !SupportsCompression(compression))
+        throw std::runtime_error("Unsupported compression of response file");
+
+    const auto buffer = std::make_unique<char[]>(ChunkSize); // единственный буфер распакованного текста
+    partial.clear();
+#ifdef ARGPARSER_WITH_ZLIB
+    if (compression == Compression::Gzip)
+    {
+        z_stream stream{};
+        if (inflateInit2(&stream, 15 + 16) != Z_OK) // 15 - окно, +16 - заголовок gzip
+            throw std::runtime_error("Can not initialize gzip decompression");
+        size_t offset = 0; // вход подается частями: avail_in - 32-битный
+        int status = Z_OK;
+        do
+        {
+            if (stream.avail_in == 0 && offset < data.size())
+            {
+                const auto part = std::min<size_t>(data.size() - offset, size_t{1} << 30);
+                stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + offset));
+                stream.avail_in = static_cast<uInt>(part);
+                offset += part;
+            }
+            stream.next_out = reinterpret_cast<Bytef*>(buffer.get());
+            stream.avail_out = ChunkSize;
+            status = inflate(&stream, Z_NO_FLUSH);
+            if (status != Z_OK && status != Z_STREAM_END) // испорчен или оборван (Z_BUF_ERROR - вход закончился)
+                break;
+            Consume({buffer.get(), ChunkSize - stream.avail_out}, args);
+            if (status == Z_STREAM_END && (stream.avail_in != 0 || offset < data.size()))
+            {
+                inflateReset(&stream); // несколько склеенных gzip-потоков
+                status = Z_OK;
+            }
+        } while (status != Z_STREAM_END);
+        inflateEnd(&stream);
+        if (status != Z_STREAM_END)
+            throw std::runtime_error("Corrupted gzip response file");
+    }
+#endif
+#ifdef ARGPARSER_WITH_ZSTD
+    if (compression == Compression::Zstd)
+    {
+        const std::unique_ptr<ZSTD_DStream, size_t(*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+        if (!stream)
+            throw std::runtime_error("Can not initialize zstd decompression");
+        ZSTD_inBuffer input{data.data(), data.size(), 0};
+        size_t status = 0;
+        while (input.pos < input.size)
+        {
+            ZSTD_outBuffer output{buffer.get(), ChunkSize, 0};
+            status = ZSTD_decompressStream(stream.get(), &output, &input);
+            if (ZSTD_isError(status))
+                throw std::runtime_error("Corrupted zstd response file");
+            Consume({buffer.get(), output.pos}, args);
+        }
+        while (status != 0) // остаток распакованного текста еще в потоке
+        {
+            ZSTD_outBuffer output{buffer.get(), ChunkSize, 0};
+            status = ZSTD_decompressStream(stream.get(), &output, &input);
+            if (ZSTD_isError(status) || output.pos == 0)
+                throw std::runtime_error("Truncated zstd response file");
+            Consume({buffer.get(), output.pos}, args);
+        }
+    }
+#endif
+    if (!partial.empty()) // последний аргумент файла
+        args.push_back(Store(partial));
+    partial.clear();
+}
+
+void CompressedArgs::Consume(std::string_view chunk, std::vector<std::string_view>& args)
+{
+    size_t pos = 0;
+    while (pos < chunk.size())
+    {
+        if (IsSpace(chunk[pos]))
+        {
+            if (!partial.empty()) // аргумент начался в прошлом фрагменте и закончился здесь
+            {
+                args.push_back(Store(partial));
+                partial.clear();
+            }
+            ++pos;
+            continue;
+        }
+        const auto end = std::find_if(chunk.begin() + static_cast<std::ptrdiff_t>(pos), chunk.end(), IsSpace) - chunk.begin();
+        const auto token = chunk.substr(pos, static_cast<size_t>(end) - pos);
+        if (static_cast<size_t>(end) == chunk.size()) // аргумент может продолжиться в следующем фрагменте
+            partial.append(token);
+        else if (partial.empty())
+            args.push_back(Store(token));
+        else
+        {
+            partial.append(token);
+            args.push_back(Store(partial));
+            partial.clear();
+        }
+        pos = static_cast<size_t>(end);
+    }
+}
+
+std::string_view CompressedArgs::Store(std::string_view token)
+{
+    if (token.size() > BlockSize) // длинный аргумент - в отдельном блоке
+    {
+        auto& block = blocks.emplace_back(std::make_unique<char[]>(token.size()));
+        std::memcpy(block.get(), token.data(), token.size());
+        return {block.get(), token.size()};
+    }
+    if (BlockSize - block_used < token.size())
+    {
+        blocks.push_back(std::make_unique<char[]>(BlockSize));
+        current_block = blocks.size() - 1;
+        block_used = 0;
+    }
+    char* const block = blocks[current_block].get() + block_used;
+    std::memcpy(block, token.data(), token.size());
+    block_used += token.size();
+    return {block, token.size()};
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Формат сжатия файла аргументов
+enum class Compression
+{
+    None,   // не сжат
+    Gzip,   // gzip (сигнатура 1f 8b)
+    Zstd    // zstd (сигнатура 28 b5 2f fd)
+};
+
+// Формат сжатия данных data по сигнатуре в начале
+Compression DetectCompression(std::string_view data);
+
+// Поддерживается ли формат compression (библиотека найдена при сборке: ARGPARSER_WITH_ZLIB, ARGPARSER_WITH_ZSTD)
+bool SupportsCompression(Compression compression);
+
+// Аргументы сжатого файла аргументов.
+// Файл распаковывается потоком через буфер фиксированного размера: распакованный текст целиком не хранится
+// ни в памяти, ни на диске. Аргументы (разделены пробельными символами, в том числе на границе фрагментов)
+// складываются в блоки внутреннего буфера; представления действительны, пока жив объект.
+class CompressedArgs
+{
+public:
+    // Распаковать data и добавить аргументы в args; при ошибке распаковки бросается std::runtime_error
+    void Split(std::string_view data, std::vector<std::string_view>& args);
+
+private:
+    // Разобрать очередной распакованный фрагмент chunk
+    void Consume(std::string_view chunk, std::vector<std::string_view>& args);
+
+    // Сохранить аргумент в буфере и вернуть представление на него
+    std::string_view Store(std::string_view token);
+
+private:
+    static constexpr size_t ChunkSize = 64 * 1024;  // размер буфера распаковки
+    static constexpr size_t BlockSize = 64 * 1024;  // размер блока буфера аргументов
+
+    std::vector<std::unique_ptr<char[]>> blocks;    // блоки буфера аргументов (не перемещаются)
+    size_t current_block = 0;                       // заполняемый блок (длинные аргументы - в своих блоках)
+    size_t block_used = BlockSize;                  // занято в заполняемом блоке
+    std::string partial;                            // начало аргумента, не закончившегося во фрагменте
+};
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Хранилище значений опции пользовательского типа (ArgParser::AddArgument<T>).
+// Значения хранятся уже преобразованными, в векторе своего типа; текст не копируется.
+class CustomValues
+{
+public:
+    virtual ~CustomValues() = default;
+
+    // Копия хранилища вместе со значениями
+    virtual std::unique_ptr<CustomValues> Clone() const = 0;
+
+    // Преобразовать text и добавить значение (multi) или заменить единственное; код ошибки преобразователя
+    virtual std::errc Add(std::string_view text, bool multi) = 0;
+
+    // Количество значений
+    virtual size_t Size() const = 0;
+
+    // Есть ли значение по умолчанию
+    virtual bool HasDefault() const = 0;
+
+    // Удалить все значения
+    virtual void Clear() = 0;
+};
+
+// Хранилище значений типа T
+template<typename T>
+class TypedValues final : public CustomValues
+{
+public:
+    // Преобразователь: записывает значение из текста в T, возвращает std::errc{} при успехе (исключений не бросает)
+    using ConverterType = std::function<std::errc(std::string_view, T&)>;
+
+    std::unique_ptr<CustomValues> Clone() const override { return std::make_unique<TypedValues>(*this); }
+
+    std::errc Add(std::string_view text, bool multi) override
+    {
+        if (!converter)
+            return std::errc::function_not_supported;
+        T value{};
+        const auto ec = converter(text, value);
+        if (ec != std::errc{}) // при ошибке значения не меняются
+            return ec;
+        if (!multi)
+            values.clear();
+        values.push_back(std::move(value));
+        return ec;
+    }
+
+    size_t Size() const override { return values.size(); }
+    bool HasDefault() const override { return default_value.has_value(); }
+    void Clear() override { values.clear(); }
+
+    // Значение в позиции pos (без значений - значение по умолчанию для pos == 0)
+    const T& Get(size_t pos) const
+    {
+        if (values.empty() && pos == 0 && default_value)
+            return *default_value;
+        return values.at(pos);
+    }
+
+    ConverterType converter;        // преобразователь текста
+    std::optional<T> default_value; // значение по умолчанию
+    std::vector<T> values;          // значения
+
+};
+
+// Указатель на хранилище, при копировании опции копирующий и значения (снимки не разделяют значения с парсером)
+class CustomValuesPtr
+{
+public:
+    CustomValuesPtr() = default;
+    explicit CustomValuesPtr(std::unique_ptr<CustomValues> values) : ptr(std::move(values)) {}
+    CustomValuesPtr(const CustomValuesPtr& other) : ptr(other.ptr ? other.ptr->Clone() : nullptr) {}
+    CustomValuesPtr(CustomValuesPtr&&) noexcept = default;
+    CustomValuesPtr& operator=(const CustomValuesPtr& other)
+    {
+        if (this != &other)
+            ptr = other.ptr ? other.ptr->Clone() : nullptr;
+        return *this;
+    }
+    CustomValuesPtr& operator=(CustomValuesPtr&&) noexcept = default;
+
+    CustomValues* get() const { return ptr.get(); }
+    CustomValues* operator->() const { return ptr.get(); }
+    explicit operator bool() const { return static_cast<bool>(ptr); }
+
+private:
+    std::unique_ptr<CustomValues> ptr;
+};
+
+}
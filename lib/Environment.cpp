@@ -0,0 +1,38 @@
+#include "Environment.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <cstdlib>
+#define environ _environ
+#else
+extern char** environ;
+#endif
+
+namespace ArgumentParser
+{
+
+Environment::Environment()
+{
+    for (char** entry = environ; entry && *entry; ++entry) // перебираем записи вида ИМЯ=ЗНАЧЕНИЕ
+    {
+        const char* eq = std::strchr(*entry, '=');
+        if (!eq) // запись без '=' - пропускаем
+            continue;
+        variables.emplace(std::string(*entry, eq - *entry), std::string(eq + 1)); // при повторах остается первая, как у getenv
+    }
+}
+
+const Environment& Environment::Snapshot()
+{
+    static const Environment snapshot; // создается один раз, при первом обращении
+    return snapshot;
+}
+
+const std::string* Environment::Find(const std::string& name) const
+{
+    const auto it = variables.find(name);
+    return it == variables.end() ? nullptr : &it->second;
+}
+
+}
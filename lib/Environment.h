@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+namespace ArgumentParser
+{
+
+// Снимок переменных окружения процесса.
+// environ просматривается один раз (при первом обращении), дальше поиск идет по хэш-таблице,
+// поэтому привязка тысяч опций к переменным окружения не требует линейного getenv для каждой.
+// Переменные, измененные после создания снимка, не видны.
+class Environment
+{
+public:
+    // Снимок окружения текущего процесса
+    static const Environment& Snapshot();
+
+    // Найти значение переменной name; nullptr, если переменной нет
+    const std::string* Find(const std::string& name) const;
+
+private:
+    Environment();
+
+private:
+    std::unordered_map<std::string, std::string> variables; // имя -> значение
+};
+
+}
@@ -0,0 +1,185 @@
+#include "Glob.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <memory>
+
+namespace ArgumentParser
+{
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    // Путь prefix/name (prefix пуст - имя в текущем каталоге)
+    std::string JoinPath(const std::string& prefix, std::string_view name)
+    {
+        if (prefix.empty())
+            return std::string(name);
+        std::string path = prefix;
+        if (path.back() != '/')
+            path += '/';
+        path += name;
+        return path;
+    }
+
+    // Имена из каталога directory, подходящие к шаблону component, в отсортированном порядке.
+    // directoriesOnly - нужны только каталоги (за шаблоном идут следующие части пути).
+    std::vector<std::string> MatchDirectory(const std::string& directory, std::string_view component, bool directoriesOnly)
+    {
+        std::vector<std::string> names;
+        std::error_code ec; // недоступный каталог - просто нет совпадений
+        for (fs::directory_iterator it(directory.empty() ? "." : directory, ec), end; !ec && it != end; it.increment(ec))
+        {
+            auto name = it->path().filename().string();
+            if (name[0] == '.' && component[0] != '.')
+                continue;
+            if (!MatchGlob(component, name))
+                continue;
+            if (directoriesOnly && !it->is_directory(ec))
+                continue;
+            names.push_back(std::move(name));
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+}
+
+bool HasGlobMagic(std::string_view pattern)
+{
+    return pattern.find_first_of("*?[") != std::string_view::npos;
+}
+
+bool MatchGlob(std::string_view pattern, std::string_view name)
+{
+    size_t p = 0, n = 0;
+    size_t starPattern = std::string_view::npos, starName = 0; // последняя '*' и позиция имени при ней
+    while (n < name.size())
+    {
+        if (p < pattern.size() && pattern[p] == '*')
+        {
+            starPattern = p++;
+            starName = n;
+            continue;
+        }
+        bool matched = false;
+        size_t next = p + 1;
+        if (p < pattern.size() && pattern[p] == '?')
+            matched = true;
+        else if (p < pattern.size() && pattern[p] == '[')
+        {
+            size_t i = p + 1;
+            const bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+            if (negate)
+                ++i;
+            bool inSet = false;
+            const size_t first = i;
+            for (; i < pattern.size() && (pattern[i] != ']' || i == first); ++i)
+            {
+                if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']')
+                {
+                    inSet |= pattern[i] <= name[n] && name[n] <= pattern[i + 2];
+                    i += 2;
+                }
+                else
+                    inSet |= pattern[i] == name[n];
+            }
+            if (i < pattern.size()) // набор закрыт
+            {
+                matched = inSet != negate;
+                next = i + 1;
+            }
+            else // незакрытая '[' - обычный символ
+                matched = name[n] == '[';
+        }
+        else if (p < pattern.size())
+            matched = pattern[p] == name[n];
+
+        if (matched)
+        {
+            p = next;
+            ++n;
+        }
+        else if (starPattern != std::string_view::npos) // '*' забирает еще один символ
+        {
+            p = starPattern + 1;
+            n = ++starName;
+        }
+        else
+            return false;
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+    return p == pattern.size();
+}
+
+bool ExpandGlob(std::string_view pattern, size_t limit, ThreadPool& pool, std::vector<std::string>& out)
+{
+    // части пути между '/'
+    std::vector<std::string_view> components;
+    for (size_t pos = 0; pos <= pattern.size();)
+    {
+        const auto slash = std::min(pattern.find('/', pos), pattern.size());
+        if (slash > pos)
+            components.push_back(pattern.substr(pos, slash - pos));
+        pos = slash + 1;
+    }
+
+    std::vector<std::string> paths = {pattern.substr(0, 1) == "/" ? "/" : ""};
+    bool checkExistence = false; // обычные части после шаблона: существование путей не проверено
+    for (size_t i = 0; i < components.size() && !paths.empty(); ++i)
+    {
+        const auto component = components[i];
+        if (!HasGlobMagic(component))
+        {
+            for (auto& path: paths)
+                path = JoinPath(path, component);
+            checkExistence = true;
+            continue;
+        }
+        // каталоги уровня просматриваются параллельно; результаты склеиваются в порядке каталогов
+        const bool directoriesOnly = i + 1 < components.size();
+        std::vector<std::shared_ptr<std::vector<std::string>>> matches(paths.size());
+        std::vector<std::future<void>> done;
+        done.reserve(paths.size());
+        for (size_t j = 0; j < paths.size(); ++j)
+        {
+            matches[j] = std::make_shared<std::vector<std::string>>();
+            done.push_back(pool.Submit([directory = paths[j], component, directoriesOnly, result = matches[j]]{
+                *result = MatchDirectory(directory, component, directoriesOnly);
+            }));
+        }
+        size_t total = 0;
+        for (size_t j = 0; j < paths.size(); ++j)
+        {
+            done[j].get();
+            total += matches[j]->size();
+        }
+        std::vector<std::string> next;
+        next.reserve(total);
+        for (size_t j = 0; j < paths.size(); ++j)
+        {
+            for (const auto& name: *matches[j])
+                next.push_back(JoinPath(paths[j], name));
+        }
+        paths = std::move(next);
+        checkExistence = false;
+    }
+
+    if (checkExistence)
+    {
+        std::error_code ec;
+        paths.erase(std::remove_if(paths.begin(), paths.end(), [&ec](const auto& path){
+            return !fs::exists(path, ec);
+        }), paths.end());
+    }
+    if (paths.size() > limit)
+        return false;
+    out.reserve(out.size() + paths.size());
+    std::move(paths.begin(), paths.end(), std::back_inserter(out));
+    return true;
+}
+
+}
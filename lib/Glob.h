@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+class ThreadPool;
+
+// Есть ли в pattern символы шаблона: *, ? или [
+bool HasGlobMagic(std::string_view pattern);
+
+// Подходит ли имя name (без '/') к шаблону pattern: * - любая последовательность, ? - любой символ,
+// [abc], [a-z], [!a] - символ из набора (или не из набора)
+bool MatchGlob(std::string_view pattern, std::string_view name);
+
+// Развернуть шаблон пути pattern (/data/2026-*/part-*.bin) в существующие пути и добавить их в out.
+// Каталоги одного уровня просматриваются параллельно на пуле pool, а результаты склеиваются в порядке
+// каталогов, и имена внутри каталога отсортированы - порядок путей не зависит от числа потоков.
+// Скрытые имена (с точкой в начале) подходят только к шаблону, который сам начинается с точки.
+// Если путей больше limit, out не меняется и возвращается false.
+bool ExpandGlob(std::string_view pattern, size_t limit, ThreadPool& pool, std::vector<std::string>& out);
+
+}
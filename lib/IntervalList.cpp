@@ -0,0 +1,48 @@
+#include "IntervalList.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ArgumentParser
+{
+
+void IntervalList::Append(int first, int last)
+{
+    if (first > last)
+        throw std::logic_error("Empty interval");
+    const auto count = static_cast<size_t>(static_cast<int64_t>(last) - first + 1);
+    if (!firsts.empty()) // продолжение последнего отрезка (..., 3-5, 6-8) - тот же отрезок
+    {
+        const auto lastValue = static_cast<int64_t>(firsts.back()) + static_cast<int64_t>(ends.back()) - 1
+            - static_cast<int64_t>(ends.size() > 1 ? ends[ends.size() - 2] : 0);
+        if (lastValue + 1 == first)
+        {
+            ends.back() += count;
+            return;
+        }
+    }
+    firsts.push_back(first);
+    ends.push_back(Size() + count);
+}
+
+size_t IntervalList::FindInterval(size_t pos) const
+{
+    // первый отрезок, кончающийся после pos
+    return static_cast<size_t>(std::upper_bound(ends.begin(), ends.end(), pos) - ends.begin());
+}
+
+int IntervalList::Get(size_t pos) const
+{
+    if (pos >= Size())
+        throw std::out_of_range("Interval list position out of range");
+    const auto index = FindInterval(pos);
+    return static_cast<int>(static_cast<int64_t>(firsts[index]) + static_cast<int64_t>(pos - Start(index)));
+}
+
+void IntervalList::Clear()
+{
+    firsts.clear();
+    ends.clear();
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Последовательность целых, записанная отрезками [first, last] (значения 1,5,9-100000 - три отрезка).
+// Значения не разворачиваются: для каждого отрезка хранится количество значений до его конца включительно,
+// поэтому размер - O(1), а значение в позиции - двоичный поиск отрезка, O(log n) по числу отрезков.
+class IntervalList
+{
+public:
+    // Добавить отрезок [first, last] в конец (first <= last); смежный с последним отрезок продолжает его
+    void Append(int first, int last);
+
+    // Значение в позиции pos
+    int Get(size_t pos) const;
+
+    // Количество значений
+    size_t Size() const { return ends.empty() ? 0 : ends.back(); }
+
+    // Количество отрезков
+    size_t IntervalCount() const { return firsts.size(); }
+
+    // Номер отрезка, в который попадает позиция pos (IntervalCount(), если pos >= Size())
+    size_t FindInterval(size_t pos) const;
+
+    // Первое значение отрезка index
+    int First(size_t index) const { return firsts[index]; }
+
+    // Количество значений до конца отрезка index включительно
+    size_t End(size_t index) const { return ends[index]; }
+
+    // Позиция первого значения отрезка index
+    size_t Start(size_t index) const { return index == 0 ? 0 : ends[index - 1]; }
+
+    // Удалить все значения
+    void Clear();
+
+private:
+    std::vector<int> firsts;    // первое значение каждого отрезка
+    std::vector<size_t> ends;   // количество значений до конца отрезка включительно
+};
+
+}
@@ -0,0 +1,89 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ArgumentParser
+{
+
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Can not open file " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Can not stat file " + path);
+    }
+
+    size = static_cast<size_t>(st.st_size);
+    if (size != 0) // пустой файл отображать нечего (mmap не принимает нулевую длину)
+    {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Can not map file " + path);
+        }
+        ::madvise(mapped, size, MADV_SEQUENTIAL); // файл читается один раз от начала до конца
+        data = static_cast<const char*>(mapped);
+    }
+    ::close(fd); // отображение остается действительным и после закрытия дескриптора
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+        ::munmap(const_cast<char*>(data), size);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data(other.data)
+        , size(other.size)
+{
+    other.data = nullptr;
+    other.size = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Can not open file " + path);
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    buffer = oss.str();
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+        : buffer(std::move(other.buffer))
+{
+    data = buffer.data();
+    size = buffer.size();
+    other.data = nullptr;
+    other.size = 0;
+}
+
+#endif
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace ArgumentParser
+{
+
+// Файл, отображенный в память только для чтения.
+// Содержимое доступно как string_view без копирования; представления действительны, пока жив объект.
+class MappedFile
+{
+public:
+    // Отобразить файл path в память
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&&) = delete;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Содержимое файла
+    std::string_view View() const { return {data, size}; }
+
+private:
+    const char* data = nullptr; // начало отображенной области
+    size_t size = 0;            // размер файла
+#ifdef _WIN32
+    std::string buffer;         // без mmap файл просто читается в память
+#endif
+};
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Битовое множество номеров опций.
+// Операции над множествами выполняются по 64 бита за раз; множества разного размера
+// считаются дополненными нулями.
+class OptionBitset
+{
+public:
+    OptionBitset() = default;
+    explicit OptionBitset(size_t size) : words((size + 63) / 64), bit_count(size) {}
+
+    // Количество битов
+    size_t Size() const { return bit_count; }
+
+    // Изменить количество битов (новые биты - нулевые)
+    void Resize(size_t size)
+    {
+        words.resize((size + 63) / 64);
+        bit_count = size;
+    }
+
+    // Установить, сбросить и проверить бит i
+    void Set(size_t i) { words[i / 64] |= uint64_t{1} << (i % 64); }
+    void Reset(size_t i) { words[i / 64] &= ~(uint64_t{1} << (i % 64)); }
+    bool Test(size_t i) const { return i < bit_count && (words[i / 64] >> (i % 64) & 1); }
+
+    // Установить биты mask в слове word (биты с номерами word * 64 + k)
+    void SetWord(size_t word, uint64_t mask) { words[word] |= mask; }
+
+    // Сбросить все биты
+    void Clear()
+    {
+        for (auto& word: words)
+            word = 0;
+    }
+
+    // Количество установленных битов
+    size_t Count() const
+    {
+        size_t count = 0;
+        for (const auto word: words)
+            count += static_cast<size_t>(__builtin_popcountll(word));
+        return count;
+    }
+
+    // Количество битов, установленных и здесь, и в other
+    size_t CountCommon(const OptionBitset& other) const
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < words.size() && i < other.words.size(); ++i)
+            count += static_cast<size_t>(__builtin_popcountll(words[i] & other.words[i]));
+        return count;
+    }
+
+    // Есть ли общие установленные биты с other
+    bool Intersects(const OptionBitset& other) const
+    {
+        for (size_t i = 0; i < words.size() && i < other.words.size(); ++i)
+        {
+            if (words[i] & other.words[i])
+                return true;
+        }
+        return false;
+    }
+
+    // Установлены ли здесь все биты other
+    bool Contains(const OptionBitset& other) const
+    {
+        for (size_t i = 0; i < other.words.size(); ++i)
+        {
+            const uint64_t word = i < words.size() ? words[i] : 0;
+            if (other.words[i] & ~word)
+                return false;
+        }
+        return true;
+    }
+
+    // Объединение с other
+    OptionBitset& operator|=(const OptionBitset& other)
+    {
+        if (other.bit_count > bit_count)
+            Resize(other.bit_count);
+        for (size_t i = 0; i < other.words.size(); ++i)
+            words[i] |= other.words[i];
+        return *this;
+    }
+
+    // Пересечение с other
+    OptionBitset& operator&=(const OptionBitset& other)
+    {
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] &= i < other.words.size() ? other.words[i] : 0;
+        return *this;
+    }
+
+    // Убрать биты, установленные в other
+    OptionBitset& AndNot(const OptionBitset& other)
+    {
+        for (size_t i = 0; i < words.size() && i < other.words.size(); ++i)
+            words[i] &= ~other.words[i];
+        return *this;
+    }
+
+    // Вызвать f(i) для каждого установленного бита по возрастанию
+    template<typename F>
+    void ForEach(F&& f) const
+    {
+        for (size_t i = 0; i < words.size(); ++i)
+        {
+            for (uint64_t word = words[i]; word != 0; word &= word - 1)
+                f(i * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+        }
+    }
+
+    bool operator==(const OptionBitset& other) const { return bit_count == other.bit_count && words == other.words; }
+    bool operator!=(const OptionBitset& other) const { return !(*this == other); }
+
+private:
+    std::vector<uint64_t> words;    // биты по 64 в слове
+    size_t bit_count = 0;           // количество битов
+};
+
+}
@@ -0,0 +1,86 @@
+#include "OptionTrie.h"
+
+#include <algorithm>
+
+namespace ArgumentParser
+{
+
+void OptionTrie::Build(std::vector<std::pair<std::string_view, uint32_t>> names)
+{
+    // сортировка по имени; при одинаковых именах первой остается опция, добавленная раньше
+    std::stable_sort(names.begin(), names.end(), [](const auto& lhs, const auto& rhs){
+        return lhs.first < rhs.first;
+    });
+    nodes.assign(1, Node{});
+    labels.clear();
+    targets.clear();
+    option_count = names.size();
+    if (!names.empty())
+        BuildNode(0, names.data(), names.data() + names.size(), 0);
+}
+
+void OptionTrie::BuildNode(uint32_t node, const std::pair<std::string_view, uint32_t>* first,
+                           const std::pair<std::string_view, uint32_t>* last, size_t depth)
+{
+    nodes[node].unique = last - first == 1 ? first->second : Ambiguous;
+    if (first->first.size() == depth) // имя заканчивается в этом узле (после сортировки оно первое)
+    {
+        nodes[node].exact = first->second;
+        while (first != last && first->first.size() == depth) // повторы имени пропускаем
+            ++first;
+    }
+
+    // сначала добавляем все ребра узла подряд, затем строим поддеревья
+    const auto firstEdge = static_cast<uint32_t>(labels.size());
+    std::vector<const std::pair<std::string_view, uint32_t>*> groups; // начала групп с общим следующим символом
+    for (auto it = first; it != last; ++it)
+    {
+        if (groups.empty() || groups.back()->first[depth] != it->first[depth])
+        {
+            groups.push_back(it);
+            labels.push_back(it->first[depth]);
+            targets.push_back(static_cast<uint32_t>(nodes.size()));
+            nodes.emplace_back();
+        }
+    }
+    nodes[node].first_edge = firstEdge;
+    nodes[node].edge_count = static_cast<uint32_t>(groups.size());
+
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        const auto groupEnd = i + 1 < groups.size() ? groups[i + 1] : last;
+        BuildNode(targets[firstEdge + i], groups[i], groupEnd, depth + 1);
+    }
+}
+
+uint32_t OptionTrie::Step(uint32_t node, char c) const
+{
+    const auto& n = nodes[node];
+    const auto begin = labels.begin() + n.first_edge;
+    const auto end = begin + n.edge_count;
+    // имена отсортированы как строки, то есть по беззнаковым байтам
+    const auto it = std::lower_bound(begin, end, c, [](char lhs, char rhs){
+        return static_cast<unsigned char>(lhs) < static_cast<unsigned char>(rhs);
+    });
+    if (it == end || *it != c)
+        return NoNode;
+    return targets[it - labels.begin()];
+}
+
+uint32_t OptionTrie::Find(std::string_view prefix) const
+{
+    if (nodes.empty())
+        return NoOption;
+    uint32_t node = Root();
+    for (char c: prefix)
+    {
+        node = Step(node, c);
+        if (node == NoNode) // дальше имен нет
+            return NoOption;
+    }
+    if (Exact(node) != NoOption) // точное совпадение важнее сокращения
+        return Exact(node);
+    return Unique(node);
+}
+
+}
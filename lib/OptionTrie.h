@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Компактное префиксное дерево длинных имен опций.
+// Строится один раз по уже зарегистрированным опциям; дочерние ребра каждого узла лежат подряд
+// в общих массивах, отсортированные по символу, поэтому переход - двоичный поиск по нескольким байтам.
+// Каждый узел знает опцию, которая в нем заканчивается, и единственную опцию своего поддерева (если она одна),
+// так что и точное совпадение, и однозначное сокращение находятся за O(длина имени).
+class OptionTrie
+{
+public:
+    static constexpr uint32_t NoNode = std::numeric_limits<uint32_t>::max();      // перехода нет
+    static constexpr uint32_t NoOption = std::numeric_limits<uint32_t>::max();    // опции нет
+    static constexpr uint32_t Ambiguous = NoOption - 1;                           // опций несколько
+
+    // Построить дерево по парам (длинное имя, номер опции)
+    void Build(std::vector<std::pair<std::string_view, uint32_t>> names);
+
+    // Корневой узел
+    uint32_t Root() const { return 0; }
+
+    // Переход из узла node по символу c (NoNode, если перехода нет)
+    uint32_t Step(uint32_t node, char c) const;
+
+    // Опция, имя которой заканчивается в узле node (NoOption, если такой нет)
+    uint32_t Exact(uint32_t node) const { return nodes[node].exact; }
+
+    // Единственная опция поддерева узла node (Ambiguous, если их несколько)
+    uint32_t Unique(uint32_t node) const { return nodes[node].unique; }
+
+    // Найти опцию по имени или его однозначному префиксу.
+    // Возвращает номер опции, NoOption (нет такой) или Ambiguous (префикс подходит к нескольким опциям).
+    uint32_t Find(std::string_view prefix) const;
+
+    // Количество опций, по которым построено дерево
+    size_t Size() const { return option_count; }
+
+private:
+    // Построить поддерево узла node для имен [first, last) с общим префиксом длины depth
+    void BuildNode(uint32_t node, const std::pair<std::string_view, uint32_t>* first,
+                   const std::pair<std::string_view, uint32_t>* last, size_t depth);
+
+private:
+    struct Node
+    {
+        uint32_t first_edge = 0;        // начало ребер узла в labels/targets
+        uint32_t edge_count = 0;        // количество ребер
+        uint32_t exact = NoOption;      // опция, заканчивающаяся в узле
+        uint32_t unique = NoOption;     // единственная опция поддерева
+    };
+
+    std::vector<Node> nodes;            // узлы (корень - нулевой)
+    std::vector<char> labels;           // символы ребер, отсортированные в пределах узла
+    std::vector<uint32_t> targets;      // узлы, в которые ведут ребра
+    size_t option_count = 0;            // количество имен
+};
+
+}
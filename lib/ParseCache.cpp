@@ -0,0 +1,63 @@
+#include "ParseCache.h"
+
+#include <functional>
+#include <string_view>
+
+namespace ArgumentParser
+{
+
+void ParseCache::SetCapacity(size_t newCapacity)
+{
+    capacity = newCapacity;
+    while (entries.size() > capacity) // лишние записи вытесняем с конца
+    {
+        index.erase(entries.back().hash);
+        entries.pop_back();
+    }
+}
+
+uint64_t ParseCache::Hash(const std::vector<std::string>& args)
+{
+    uint64_t hash = args.size();
+    for (const auto& arg: args) // хэши аргументов перемешиваются с учетом порядка
+    {
+        const uint64_t h = std::hash<std::string_view>{}(arg);
+        hash ^= h + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+std::shared_ptr<const ParseResult> ParseCache::Find(uint64_t hash, const std::vector<std::string>& args)
+{
+    const auto it = index.find(hash);
+    if (it == index.end() || it->second->args != args) // нет записи или коллизия хэша
+    {
+        ++stats.misses;
+        return nullptr;
+    }
+    ++stats.hits;
+    entries.splice(entries.begin(), entries, it->second); // запись становится самой недавней
+    return it->second->result;
+}
+
+void ParseCache::Insert(uint64_t hash, const std::vector<std::string>& args, std::shared_ptr<const ParseResult> result)
+{
+    if (capacity == 0)
+        return;
+
+    const auto it = index.find(hash);
+    if (it != index.end()) // коллизия - старая запись заменяется
+    {
+        entries.erase(it->second);
+        index.erase(it);
+    }
+    else if (entries.size() == capacity) // места нет - вытесняем самую давнюю
+    {
+        index.erase(entries.back().hash);
+        entries.pop_back();
+    }
+    entries.push_front({hash, args, std::move(result)});
+    index.emplace(hash, entries.begin());
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ParseResult.h"
+
+namespace ArgumentParser
+{
+
+// Ограниченный LRU-кэш результатов разбора.
+// Ключ - 64-битный хэш списка аргументов; при совпадении хэша списки сравниваются целиком,
+// так что коллизия приводит к промаху, а не к чужому результату.
+class ParseCache
+{
+public:
+    // Счетчики обращений к кэшу
+    struct Stats
+    {
+        size_t hits = 0;    // попадания
+        size_t misses = 0;  // промахи
+    };
+
+    // Установить максимальное количество результатов (0 - кэш выключен)
+    void SetCapacity(size_t capacity);
+
+    // Хэш списка аргументов
+    static uint64_t Hash(const std::vector<std::string>& args);
+
+    // Найти результат для args (nullptr при промахе)
+    std::shared_ptr<const ParseResult> Find(uint64_t hash, const std::vector<std::string>& args);
+
+    // Сохранить результат для args, вытеснив самый давно использованный при переполнении
+    void Insert(uint64_t hash, const std::vector<std::string>& args, std::shared_ptr<const ParseResult> result);
+
+    // Счетчики обращений
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct Entry
+    {
+        uint64_t hash;                              // хэш аргументов
+        std::vector<std::string> args;              // аргументы (для проверки при совпадении хэша)
+        std::shared_ptr<const ParseResult> result;  // результат разбора
+    };
+
+    size_t capacity = 0;                                            // максимальное количество результатов
+    std::list<Entry> entries;                                       // от недавно использованных к давним
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index; // хэш -> запись
+    Stats stats;                                                    // счетчики
+};
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Класс перечисления вида ошибки разбора
+enum class ParseErrorCode
+{
+    InvalidArgument,    // некорректный аргумент (пустой, "-", "--opt=" и т.п.)
+    UnknownOption,      // нет опции с таким именем
+    AmbiguousOption,    // сокращение подходит к нескольким опциям
+    InvalidValue,       // значение не подходит к типу опции
+    MissingValue,       // у опции нет значения (или их меньше минимального количества)
+    ConstraintViolation,// нарушено ограничение группы опций (MutuallyExclusive, AtLeastOneOf, Requires)
+    InvalidPath         // путь не прошел проверку опции-пути (MustExist, MustBeReadable)
+};
+
+// Описание одной ошибки разбора аргументов
+struct ParseError
+{
+    ParseErrorCode code;                    // вид ошибки
+    std::string option;                     // опция или аргумент, к которому относится ошибка
+    std::string message;                    // текст ошибки
+    std::vector<std::string> suggestions{}; // похожие имена опций (для UnknownOption)
+};
+
+// Исключение, которым ошибка разбора передается из вспомогательных методов в Parse
+class ParseException : public std::logic_error
+{
+public:
+    explicit ParseException(ParseError error)
+            : std::logic_error(error.message)
+            , error(std::move(error))
+    {}
+
+    // Описание ошибки
+    const ParseError& GetError() const { return error; }
+
+private:
+    ParseError error;
+};
+
+}
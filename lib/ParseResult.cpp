@@ -0,0 +1,97 @@
+#include "ParseResult.h"
+
+#include <algorithm>
+
+namespace ArgumentParser
+{
+
+ParseResult::ParseResult(std::shared_ptr<const NameIndex> index,
+                         std::vector<std::shared_ptr<const CommandLineOption>> options,
+                         std::vector<ParseError> errors)
+        : index(std::move(index))
+        , options(std::move(options))
+        , errors(std::move(errors))
+{}
+
+bool ParseResult::GetFlag(const std::string& longOpt) const
+{
+    const auto it = index->find(longOpt);
+    if (it != index->end() && it->second < flags.Size() && options[it->second]->GetType() == OptionType::FlagOption)
+        return flags.Test(it->second); // значения флагов хранятся в битовом множестве
+    return GetOption(longOpt).GetFlag();
+}
+
+int ParseResult::GetIntValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetInt();
+}
+
+int ParseResult::GetIntValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetInt(pos);
+}
+
+IntValues ParseResult::GetIntValues(const std::string& longOpt) const
+{
+    return IntValues(GetOption(longOpt));
+}
+
+double ParseResult::GetDoubleValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetDouble();
+}
+
+double ParseResult::GetDoubleValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetDouble(pos);
+}
+
+uint64_t ParseResult::GetSizeValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetSize();
+}
+
+uint64_t ParseResult::GetSizeValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetSize(pos);
+}
+
+std::chrono::nanoseconds ParseResult::GetDurationValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetDuration();
+}
+
+std::chrono::nanoseconds ParseResult::GetDurationValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetDuration(pos);
+}
+
+std::string ParseResult::GetStringValue(const std::string& longOpt) const
+{
+    return GetOption(longOpt).GetString();
+}
+
+std::string ParseResult::GetStringValue(const std::string& longOpt, size_t pos) const
+{
+    return GetOption(longOpt).GetString(pos);
+}
+
+bool ParseResult::Help() const
+{
+    const auto it = std::find_if(options.begin(), options.end(), [](const auto& opt){
+        return opt->GetType() == OptionType::HelpOption;
+    });
+    if (it == options.end()) // не найдено - ошибка
+        throw std::logic_error("No help option");
+    return (*it)->GetFlag();
+}
+
+const CommandLineOption& ParseResult::GetOption(const std::string& longOpt) const
+{
+    const auto it = index->find(longOpt);
+    if (it == index->end()) // не найдено - ошибка
+        throw std::logic_error("No option named " + longOpt);
+    return *options[it->second];
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CommandLineOption.h"
+#include "OptionBitset.h"
+#include "ParseError.h"
+
+namespace ArgumentParser
+{
+
+// Неизменяемый результат разбора: снимок значений всех опций и ошибок.
+// Снимки опций разделяются между результатами (shared_ptr), поэтому результат можно
+// отдавать нескольким потребителям и хранить в кэше без копирования значений.
+// Подкоманды в результат не входят.
+class ParseResult
+{
+public:
+    // Индекс опций по длинному имени (общий для всех результатов одного парсера)
+    using NameIndex = std::unordered_map<std::string, size_t>;
+
+    ParseResult(std::shared_ptr<const NameIndex> index,
+                std::vector<std::shared_ptr<const CommandLineOption>> options,
+                std::vector<ParseError> errors);
+
+    // Успешен ли разбор
+    bool Success() const { return errors.empty(); }
+
+    // Ошибки разбора
+    const std::vector<ParseError>& GetErrors() const { return errors; }
+
+    // Значения опций - так же, как у ArgParser
+    bool GetFlag(const std::string& longOpt) const;
+    int GetIntValue(const std::string& longOpt) const;
+    int GetIntValue(const std::string& longOpt, size_t pos) const;
+    IntValues GetIntValues(const std::string& longOpt) const;
+    double GetDoubleValue(const std::string& longOpt) const;
+    double GetDoubleValue(const std::string& longOpt, size_t pos) const;
+    uint64_t GetSizeValue(const std::string& longOpt) const;
+    uint64_t GetSizeValue(const std::string& longOpt, size_t pos) const;
+    std::chrono::nanoseconds GetDurationValue(const std::string& longOpt) const;
+    std::chrono::nanoseconds GetDurationValue(const std::string& longOpt, size_t pos) const;
+    std::string GetStringValue(const std::string& longOpt) const;
+    std::string GetStringValue(const std::string& longOpt, size_t pos) const;
+    template<typename E>
+    E GetEnumValue(const std::string& longOpt) const { return static_cast<E>(GetIntValue(longOpt)); }
+    template<typename E>
+    E GetEnumValue(const std::string& longOpt, size_t pos) const { return static_cast<E>(GetIntValue(longOpt, pos)); }
+    template<typename T>
+    const T& GetValue(const std::string& longOpt, size_t pos = 0) const { return GetOption(longOpt).GetCustom<T>(pos); }
+
+    // Запрашивается ли справка
+    bool Help() const;
+
+    // Значения всех флагов: бит с номером опции-флага (ArgParser::FlagId) - ее значение
+    const OptionBitset& FlagsBitset() const { return flags; }
+
+    // Снимок опции с (длинным) именем longOpt
+    const CommandLineOption& GetOption(const std::string& longOpt) const;
+
+private:
+    friend class ArgParser;
+
+    std::shared_ptr<const NameIndex> index;                         // длинное имя -> номер опции
+    std::vector<std::shared_ptr<const CommandLineOption>> options;  // снимки опций
+    std::vector<ParseError> errors;                                 // ошибки разбора
+    OptionBitset flags;                                             // значения флагов по номерам опций
+
+    // Сведения для повторного разбора после правки аргументов (ArgParser::Reparse)
+    std::shared_ptr<const std::vector<std::string>> args;           // разобранные аргументы
+    size_t positional_start = 0;                                    // первый позиционный аргумент (или размер args)
+    std::vector<std::vector<uint32_t>> sources;                     // номера аргументов со значениями каждой опции
+    OptionBitset seen;                                              // опции, получившие значения (не по умолчанию)
+    bool incremental = false;                                       // можно ли разбирать правки по частям
+};
+
+}
@@ -0,0 +1,114 @@
+#include "PathChecker.h"
+#include "ThreadPool.h"
+
+
+#ifdef _WIN32
+#include <filesystem>
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ArgumentParser
+{
+
+FileHandle::~FileHandle()
+{
+#ifndef _WIN32
+    if (fd >= 0)
+        ::close(fd);
+#endif
+}
+
+FileHandle& FileHandle::operator=(FileHandle&& other) noexcept
+{
+    if (this != &other)
+    {
+        FileHandle old(fd); // прежний дескриптор закрывается
+        fd = other.fd;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+void PathChecker::Add(ThreadPool& pool, size_t id, const std::string& option, std::string_view path, uint8_t checks)
+{
+    current_pool = &pool;
+    if (!current)
+    {
+        current = std::make_shared<Batch>();
+        current->reserve(BatchSize);
+    }
+    current->push_back({id, &option, std::string(path), checks, {}, {}});
+    if (current->size() == BatchSize)
+        Flush(pool);
+}
+
+void PathChecker::Flush(ThreadPool& pool)
+{
+    if (!current)
+        return;
+    pending.push_back(pool.Submit([batch = current]{
+        for (auto& item: *batch)
+            Check(item);
+    }));
+    batches.push_back(std::move(current));
+    current.reset();
+}
+
+void PathChecker::Collect(std::vector<ParseError>& errors, std::vector<std::vector<FileHandle>>& files)
+{
+    if (current_pool)
+        Flush(*current_pool);
+    for (auto& done: pending) // ждем только свои пакеты: на пуле могут быть и другие задачи
+        done.get();
+    pending.clear();
+    for (const auto& batch: batches)
+    {
+        for (auto& item: *batch)
+        {
+            if (!item.error.empty())
+                errors.push_back({ParseErrorCode::InvalidPath, *item.option, item.error});
+            if (item.checks & PathPrefetch)
+            {
+                if (files.size() <= item.id)
+                    files.resize(item.id + 1);
+                files[item.id].push_back(std::move(item.file));
+            }
+        }
+    }
+    batches.clear();
+}
+
+void PathChecker::Check(Item& item)
+{
+    const auto fail = [&item](const char* what) {
+        item.error = "Path " + item.path + " for option " + *item.option + " " + what;
+    };
+#ifndef _WIN32
+    struct stat st{};
+    if ((item.checks & PathMustExist) && ::stat(item.path.c_str(), &st) != 0)
+        return fail("does not exist");
+    if ((item.checks & PathMustBeReadable) && ::access(item.path.c_str(), R_OK) != 0)
+        return fail("is not readable");
+    if (item.checks & PathPrefetch) // открываем заранее; чтение в кэш ядро начинает асинхронно
+    {
+        item.file = FileHandle(::open(item.path.c_str(), O_RDONLY | O_CLOEXEC));
+#ifdef POSIX_FADV_WILLNEED
+        if (item.file.Get() >= 0)
+            ::posix_fadvise(item.file.Get(), 0, 0, POSIX_FADV_WILLNEED);
+#endif
+    }
+#else // без posix_fadvise файл не открывается заранее (дескриптор -1)
+    std::error_code ec;
+    if ((item.checks & PathMustExist) && !std::filesystem::exists(item.path, ec))
+        return fail("does not exist");
+    if ((item.checks & PathMustBeReadable) && !std::filesystem::is_directory(item.path, ec) &&
+        !std::ifstream(item.path))
+        return fail("is not readable");
+#endif
+}
+
+}
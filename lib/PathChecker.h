@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ParseError.h"
+
+namespace ArgumentParser
+{
+
+class ThreadPool;
+
+// Проверки значения опции-пути (битовая маска)
+enum PathCheck : uint8_t
+{
+    PathMustExist = 1,      // путь существует
+    PathMustBeReadable = 2, // файл или каталог доступен для чтения
+    PathPrefetch = 4        // открыть файл заранее и попросить ядро прочитать его в кэш (Prefetch)
+};
+
+// Открытый дескриптор файла; закрывается вместе с объектом
+class FileHandle
+{
+public:
+    FileHandle() = default;
+    explicit FileHandle(int fd) : fd(fd) {}
+    ~FileHandle();
+
+    FileHandle(FileHandle&& other) noexcept : fd(other.fd) { other.fd = -1; }
+    FileHandle& operator=(FileHandle&& other) noexcept;
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+
+    // Дескриптор (-1 - файл не открыт)
+    int Get() const { return fd; }
+
+private:
+    int fd = -1;
+};
+
+// Пакетная проверка (и открытие) путей на пуле потоков.
+// Пути добавляются по мере разбора аргументов и проверяются пакетами в фоне, пока разбор продолжается;
+// Collect дожидается проверок и возвращает ошибки и открытые файлы в порядке добавления путей.
+class PathChecker
+{
+public:
+    // Поставить в очередь проверки checks пути path опции option с номером id; пакеты проверяются на пуле pool
+    void Add(ThreadPool& pool, size_t id, const std::string& option, std::string_view path, uint8_t checks);
+
+    // Дождаться всех проверок: ошибки - в errors, открытые файлы (PathPrefetch) - в files[номер опции].
+    // Очередь очищается.
+    void Collect(std::vector<ParseError>& errors, std::vector<std::vector<FileHandle>>& files);
+
+private:
+    // Путь и результат его проверки
+    struct Item
+    {
+        size_t id;                  // номер опции
+        const std::string* option;  // имя опции (строка живет в опции парсера)
+        std::string path;           // проверяемый путь
+        uint8_t checks;             // проверки (PathCheck)
+        std::string error;          // текст ошибки (пусто - проверки пройдены)
+        FileHandle file;            // открытый файл (PathPrefetch)
+    };
+
+    // Пакет путей, проверяемый одной задачей пула
+    using Batch = std::vector<Item>;
+
+    // Отправить текущий пакет на проверку
+    void Flush(ThreadPool& pool);
+
+    // Проверить (и открыть) путь item и записать результат в него
+    static void Check(Item& item);
+
+private:
+    // Путей в одном пакете: задача на каждый путь дороже самой проверки
+    static constexpr size_t BatchSize = 32;
+
+    std::vector<std::shared_ptr<Batch>> batches; // отправленные пакеты в порядке добавления
+    std::vector<std::future<void>> pending;     // завершение проверки каждого отправленного пакета
+    std::shared_ptr<Batch> current;             // заполняемый пакет
+    ThreadPool* current_pool = nullptr;         // пул, на котором будет проверен заполняемый пакет
+};
+
+}
@@ -0,0 +1,95 @@
+#include "PerfectHash.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ArgumentParser
+{
+
+namespace
+{
+    // среднее количество ключей в корзине
+    constexpr size_t KeysPerBucket = 4;
+    // сколько зерен перебрать для одной корзины, прежде чем признать набор ключей некорректным
+    constexpr uint32_t MaxSeed = 1u << 20;
+}
+
+uint64_t PerfectHash::Hash(uint64_t seed, std::string_view key)
+{
+    uint64_t hash = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull); // FNV-1a с примесью зерна
+    for (const auto c: key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    hash ^= hash >> 29; // перемешиваем старшие биты в младшие
+    hash *= 0xBF58476D1CE4E5B9ull;
+    return hash ^ (hash >> 32);
+}
+
+void PerfectHash::Build(const std::vector<std::string_view>& keysToAdd)
+{
+    auto sorted = keysToAdd; // с повторами подходящего зерна не существует - проверяем заранее
+    std::sort(sorted.begin(), sorted.end());
+    const auto duplicate = std::adjacent_find(sorted.begin(), sorted.end());
+    if (duplicate != sorted.end())
+        throw std::logic_error("Duplicate key " + std::string(*duplicate));
+
+    keys.assign(keysToAdd.begin(), keysToAdd.end());
+    const size_t size = keys.size();
+    seeds.assign(std::max<size_t>(1, (size + KeysPerBucket - 1) / KeysPerBucket), 0);
+    slots.assign(size + size / 4 + 1, NoKey); // небольшой запас ячеек ускоряет подбор зерен
+
+    std::vector<std::vector<uint32_t>> buckets(seeds.size());
+    for (uint32_t id = 0; id < size; ++id)
+        buckets[Hash(0, keys[id]) % buckets.size()].push_back(id);
+
+    std::vector<uint32_t> order(buckets.size()); // сначала большие корзины: им труднее найти место
+    for (uint32_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&buckets](uint32_t lhs, uint32_t rhs){
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<size_t> taken;
+    for (const auto bucket: order)
+    {
+        if (buckets[bucket].empty())
+            break;
+        uint32_t seed = 1;
+        for (; seed < MaxSeed; ++seed) // подбираем зерно, при котором все ключи корзины в свободных разных ячейках
+        {
+            taken.clear();
+            bool fits = true;
+            for (const auto id: buckets[bucket])
+            {
+                const size_t slot = Hash(seed, keys[id]) % slots.size();
+                if (slots[slot] != NoKey || std::find(taken.begin(), taken.end(), slot) != taken.end())
+                {
+                    fits = false;
+                    break;
+                }
+                taken.push_back(slot);
+            }
+            if (fits)
+                break;
+        }
+        if (seed == MaxSeed)
+            throw std::logic_error("Can not build perfect hash");
+
+        seeds[bucket] = seed;
+        for (size_t i = 0; i < taken.size(); ++i)
+            slots[taken[i]] = buckets[bucket][i];
+    }
+}
+
+uint32_t PerfectHash::Find(std::string_view key) const
+{
+    if (keys.empty())
+        return NoKey;
+    const auto seed = seeds[Hash(0, key) % seeds.size()];
+    const auto id = slots[Hash(seed, key) % slots.size()];
+    return id != NoKey && keys[id] == key ? id : NoKey;
+}
+
+}
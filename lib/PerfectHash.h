@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Совершенная хеш-функция для фиксированного набора строк (метод "hash and displace").
+// Ключи раскладываются по корзинам; для каждой корзины при построении подбирается зерно хеша,
+// при котором ее ключи попадают в свободные ячейки таблицы. Поиск - два хеша и одно сравнение строк.
+class PerfectHash
+{
+public:
+    // Номер, возвращаемый для отсутствующего ключа
+    static constexpr uint32_t NoKey = UINT32_MAX;
+
+    // Построить функцию для ключей keys (ключи не должны повторяться)
+    void Build(const std::vector<std::string_view>& keys);
+
+    // Номер ключа key в keys, переданных в Build, или NoKey
+    uint32_t Find(std::string_view key) const;
+
+    // Ключ с номером id
+    const std::string& Key(uint32_t id) const { return keys[id]; }
+
+    // Количество ключей
+    size_t Size() const { return keys.size(); }
+
+private:
+    // Хеш ключа key с зерном seed
+    static uint64_t Hash(uint64_t seed, std::string_view key);
+
+private:
+    std::vector<std::string> keys;  // ключи (для проверки найденного)
+    std::vector<uint32_t> seeds;    // зерно хеша каждой корзины
+    std::vector<uint32_t> slots;    // ячейка таблицы -> номер ключа (или NoKey)
+};
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace ArgumentParser
+{
+
+// Найти в [first, last) первый байт, равный одному из bytes...; last, если таких нет.
+// При наличии SSE2 проверяется по 16 байт за раз: сравнение с каждым искомым байтом,
+// объединение масок и поиск первого установленного бита.
+template<typename... Bytes>
+inline const char* FindAnyOf(const char* first, const char* last, Bytes... bytes)
+{
+#ifdef __SSE2__
+    while (last - first >= 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i hits = _mm_setzero_si128();
+        ((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(bytes)))), ...);
+        const int mask = _mm_movemask_epi8(hits);
+        if (mask != 0)
+            return first + __builtin_ctz(static_cast<unsigned>(mask));
+        first += 16;
+    }
+#endif
+    for (; first != last; ++first) // хвост (или весь диапазон без SSE2)
+    {
+        if (((*first == bytes) || ...))
+            return first;
+    }
+    return last;
+}
+
+}
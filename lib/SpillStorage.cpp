@@ -0,0 +1,86 @@
+#include "SpillStorage.h"
+
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ArgumentParser
+{
+
+namespace
+{
+    // начальный размер отображаемой области (в значениях); дальше область удваивается
+    constexpr size_t InitialCapacity = 1 << 16;
+}
+
+#ifndef _WIN32
+
+SpillStorage::SpillStorage(const std::string& directory)
+{
+    std::string pattern = directory + "/argparser-XXXXXX"; // шаблон имени временного файла
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    fd = ::mkstemp(path.data());
+    if (fd < 0) // не удалось создать файл - ошибка
+        throw std::runtime_error("Can not create spill file in " + directory);
+    ::unlink(path.data()); // имя больше не нужно: файл живет, пока открыт дескриптор
+}
+
+SpillStorage::~SpillStorage()
+{
+    if (data)
+        ::munmap(data, capacity * sizeof(int));
+    if (fd >= 0)
+        ::close(fd);
+}
+
+void SpillStorage::Grow()
+{
+    const size_t newCapacity = capacity ? capacity * 2 : InitialCapacity;
+    if (::ftruncate(fd, static_cast<off_t>(newCapacity * sizeof(int))) != 0)
+        throw std::runtime_error("Can not grow spill file");
+
+    void* mapped = ::mmap(nullptr, newCapacity * sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+        throw std::runtime_error("Can not map spill file");
+
+    if (data) // старое отображение больше не нужно - данные уже в файле
+        ::munmap(data, capacity * sizeof(int));
+    data = static_cast<int*>(mapped);
+    capacity = newCapacity;
+}
+
+#else
+
+SpillStorage::SpillStorage(const std::string&)
+{
+    throw std::logic_error("Spill storage is not supported on this platform");
+}
+
+SpillStorage::~SpillStorage() = default;
+
+void SpillStorage::Grow()
+{
+}
+
+#endif
+
+void SpillStorage::Append(int value)
+{
+    if (size == capacity) // место закончилось - расширяем файл
+        Grow();
+    data[size++] = value;
+}
+
+int SpillStorage::Get(size_t pos) const
+{
+    if (pos >= size)
+        throw std::out_of_range("Spill storage position out of range");
+    return data[pos];
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ArgumentParser
+{
+
+// Хранилище целых значений во временном файле, отображенном в память.
+// Используется MultiValue опциями, когда значений больше, чем разрешено держать в памяти:
+// значения дописываются в конец файла, а за их присутствие в оперативной памяти отвечает страничный кэш ядра.
+// Файл удаляется из каталога сразу после создания и исчезает вместе с закрытием дескриптора.
+class SpillStorage
+{
+public:
+    // Создать временный файл в каталоге directory
+    explicit SpillStorage(const std::string& directory);
+    ~SpillStorage();
+
+    SpillStorage(const SpillStorage&) = delete;
+    SpillStorage& operator=(const SpillStorage&) = delete;
+
+    // Добавить значение в конец хранилища
+    void Append(int value);
+
+    // Получить значение в позиции pos
+    int Get(size_t pos) const;
+
+    // Количество сохраненных значений
+    size_t Size() const { return size; }
+
+private:
+    // Увеличить размер файла и заново отобразить его в память
+    void Grow();
+
+private:
+    int fd = -1;            // дескриптор временного файла
+    int* data = nullptr;    // отображенная в память область файла
+    size_t size = 0;        // количество сохраненных значений
+    size_t capacity = 0;    // вместимость отображенной области (в значениях)
+};
+
+}
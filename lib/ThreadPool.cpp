@@ -0,0 +1,67 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace ArgumentParser
+{
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back([this]{ Work(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    task_ready.notify_all();
+    for (auto& worker: workers)
+        worker.join();
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+    // packaged_task не копируется, а очередь хранит std::function - держим задачу через shared_ptr
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    auto result = packaged->get_future();
+    {
+        std::lock_guard lock(mutex);
+        tasks.emplace_back([packaged]{ (*packaged)(); });
+    }
+    task_ready.notify_one();
+    return result;
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock lock(mutex);
+    idle.wait(lock, [this]{ return tasks.empty() && running == 0; });
+}
+
+void ThreadPool::Work()
+{
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+        task_ready.wait(lock, [this]{ return stopping || !tasks.empty(); });
+        if (tasks.empty()) // остановка: очередь разобрана
+            return;
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        ++running;
+        lock.unlock();
+        task();
+        lock.lock();
+        --running;
+        if (tasks.empty() && running == 0)
+            idle.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ArgumentParser
+{
+
+// Пул потоков для фоновой работы парсера (проверки путей, обход каталогов для шаблонов и т.п.).
+// Задачи выполняются в порядке добавления свободными потоками; завершения одной задачи ждут через ее future,
+// всех добавленных - через Wait.
+class ThreadPool
+{
+public:
+    // Запустить threads потоков (0 - по числу ядер)
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Добавить задачу; исключение из задачи передается через future
+    std::future<void> Submit(std::function<void()> task);
+
+    // Дождаться завершения всех добавленных задач
+    void Wait();
+
+    // Количество потоков
+    size_t Size() const { return workers.size(); }
+
+private:
+    // Цикл потока: берем задачи из очереди, пока пул не остановлен
+    void Work();
+
+private:
+    std::vector<std::thread> workers;               // потоки
+    std::deque<std::function<void()>> tasks;        // очередь задач
+    std::mutex mutex;                               // защищает очередь и счетчики
+    std::condition_variable task_ready;             // появилась задача (или пул останавливается)
+    std::condition_variable idle;                   // задачи закончились
+    size_t running = 0;                             // выполняемые сейчас задачи
+    bool stopping = false;                          // пул останавливается
+};
+
+}
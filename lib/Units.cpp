@@ -0,0 +1,181 @@
+#include "Units.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace ArgumentParser
+{
+
+namespace
+{
+    // Прочитать неотрицательное число в начале text; text сдвигается за него
+    bool ReadNumber(std::string_view& text, double& value)
+    {
+        if (text.empty() || text[0] == '-' || text[0] == '+') // знак не допускается
+            return false;
+        const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value,
+                                               std::chars_format::fixed);
+        if (ec != std::errc{} || !std::isfinite(value))
+            return false;
+        text.remove_prefix(static_cast<size_t>(end - text.data()));
+        return true;
+    }
+
+    // Единицы длительности в наносекундах
+    constexpr double Nanosecond = 1;
+    constexpr double Microsecond = 1e3;
+    constexpr double Millisecond = 1e6;
+    constexpr double Second = 1e9;
+    constexpr double Minute = 60 * Second;
+    constexpr double Hour = 60 * Minute;
+    constexpr double Day = 24 * Hour;
+}
+
+bool ParseDouble(std::string_view text, double& value)
+{
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && ec == std::errc{} && end == text.data() + text.size();
+}
+
+bool ParseByteSize(std::string_view text, uint64_t& value)
+{
+    double number = 0;
+    if (!ReadNumber(text, number))
+        return false;
+
+    // автомат суффикса: [KMGTPE] [i] [B] | B | пусто
+    double multiplier = 1;
+    size_t pos = 0;
+    if (pos < text.size())
+    {
+        int power = 0;
+        switch (text[pos])
+        {
+            case 'K': case 'k': power = 1; break;
+            case 'M': power = 2; break;
+            case 'G': power = 3; break;
+            case 'T': power = 4; break;
+            case 'P': power = 5; break;
+            case 'E': power = 6; break;
+            case 'B': break;
+            default: return false;
+        }
+        if (power != 0)
+        {
+            ++pos;
+            double base = 1024;
+            if (pos < text.size() && text[pos] == 'i') // KiB - обязательно с B
+            {
+                if (pos + 1 >= text.size() || text[pos + 1] != 'B')
+                    return false;
+                pos += 2;
+            }
+            else if (pos < text.size() && text[pos] == 'B') // KB - десятичная степень
+            {
+                base = 1000;
+                ++pos;
+            }
+            multiplier = std::pow(base, power);
+        }
+        else
+            ++pos; // B
+    }
+    if (pos != text.size())
+        return false;
+
+    const double bytes = std::floor(number * multiplier);
+    if (bytes >= 18446744073709551616.0) // не помещается в uint64_t
+        return false;
+    value = static_cast<uint64_t>(bytes);
+    return true;
+}
+
+bool ParseDuration(std::string_view text, std::chrono::nanoseconds& value)
+{
+    if (text.empty()) // пустое значение - не ноль
+        return false;
+    if (text == "0")
+    {
+        value = std::chrono::nanoseconds{0};
+        return true;
+    }
+
+    double total = 0;
+    while (!text.empty()) // пары <число><единица>
+    {
+        double number = 0;
+        if (!ReadNumber(text, number) || text.empty())
+            return false;
+
+        double unit = 0; // автомат единицы: первый символ и, возможно, 's' после него
+        const char first = text[0];
+        const bool secondS = text.size() > 1 && text[1] == 's';
+        switch (first)
+        {
+            case 'n': unit = secondS ? Nanosecond : 0; break;
+            case 'u': unit = secondS ? Microsecond : 0; break;
+            case 'm': unit = secondS ? Millisecond : Minute; break;
+            case 's': unit = Second; break;
+            case 'h': unit = Hour; break;
+            case 'd': unit = Day; break;
+            default: break;
+        }
+        if (unit == 0)
+            return false;
+        text.remove_prefix((first == 'n' || first == 'u' || (first == 'm' && secondS)) ? 2 : 1);
+        total += number * unit;
+    }
+    if (total >= 9223372036854775807.0) // не помещается в nanoseconds
+        return false;
+    value = std::chrono::nanoseconds{static_cast<int64_t>(std::llround(total))};
+    return true;
+}
+
+std::string FormatByteSize(uint64_t value)
+{
+    static constexpr char suffixes[] = {'K', 'M', 'G', 'T', 'P', 'E'};
+    int power = 0;
+    while (power < 6 && value != 0 && value % 1024 == 0)
+    {
+        value /= 1024;
+        ++power;
+    }
+    auto text = std::to_string(value);
+    if (power != 0)
+        text += suffixes[power - 1];
+    return text;
+}
+
+std::string FormatDuration(std::chrono::nanoseconds value)
+{
+    struct Unit
+    {
+        int64_t size;
+        const char* name;
+    };
+    static constexpr Unit units[] = {
+        {86400000000000, "d"}, {3600000000000, "h"}, {60000000000, "m"},
+        {1000000000, "s"}, {1000000, "ms"}, {1000, "us"}, {1, "ns"}
+    };
+
+    auto rest = value.count();
+    if (rest == 0)
+        return "0s";
+    std::string text;
+    if (rest < 0) // отрицательная бывает только у значения по умолчанию
+    {
+        text = "-";
+        rest = -rest;
+    }
+    for (const auto& unit: units) // по убыванию единиц: 1h30m, 1s250ms
+    {
+        if (rest >= unit.size)
+        {
+            text += std::to_string(rest / unit.size) + unit.name;
+            rest %= unit.size;
+        }
+    }
+    return text;
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ArgumentParser
+{
+
+// Разбор и вывод значений опций с единицами измерения.
+// Разбор не зависит от локали и не выделяет память: число читается std::from_chars,
+// суффикс - конечным автоматом по символам.
+
+// Вещественное число; значение должно занимать text целиком
+bool ParseDouble(std::string_view text, double& value);
+
+// Размер в байтах: число (возможно дробное) и необязательный суффикс.
+// K, M, G, T, P, E, а также KiB, MiB, ... - степени 1024; KB, MB, ... - степени 1000; B - байты.
+bool ParseByteSize(std::string_view text, uint64_t& value);
+
+// Длительность: одна или несколько пар <число><единица> подряд (1h30m, 1.5s, 250ms).
+// Единицы: ns, us, ms, s, m, h, d. Одиночный 0 допускается без единицы.
+bool ParseDuration(std::string_view text, std::chrono::nanoseconds& value);
+
+// Размер в виде, пригодном для ParseByteSize: наибольшая степень 1024, на которую он делится (64K, 3G, 100)
+std::string FormatByteSize(uint64_t value);
+
+// Длительность в виде, пригодном для ParseDuration (1h30m, 250ms, 0s)
+std::string FormatDuration(std::chrono::nanoseconds value);
+
+}
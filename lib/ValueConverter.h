@@ -0,0 +1,121 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "CommandLineOption.h"
+#include "ParseError.h"
+#include "Units.h"
+
+namespace ArgumentParser
+{
+
+// Преобразование текста значения опции в значение C++ типа.
+// Используется и при установке значений опций, и при записи прямо в поля структуры (ArgParser::Bind).
+
+// Ошибка: значение value не подходит к опции option
+inline ParseException WrongValue(const CommandLineOption& option, std::string_view value)
+{
+    return ParseException({ParseErrorCode::InvalidValue, option.GetLongOption(),
+                           "Wrong value " + std::string(value) + " for option " + option.GetLongOption(), {}});
+}
+
+template<typename T>
+struct IsValueVector : std::false_type {};
+template<typename T>
+struct IsValueVector<std::vector<T>> : std::true_type {};
+
+// Преобразовать value в значение типа T для опции option; вектор - добавить в конец.
+// Если значение не подходит, бросается ParseException.
+template<typename T>
+void ConvertValue(const CommandLineOption& option, std::string_view value, T& out)
+{
+    if constexpr (std::is_same_v<T, bool>) // флаг: пусто, "0", "false", "no", "off" - false, иначе true
+        out = !(value.empty() || value == "0" || value == "false" || value == "no" || value == "off");
+    else if constexpr (std::is_enum_v<T>)
+    {
+        int number = 0;
+        ConvertValue(option, value, number);
+        out = static_cast<T>(number);
+    }
+    else if constexpr (std::is_same_v<T, int>)
+    {
+        if (option.GetType() == OptionType::EnumOption) // перечисление - значение по имени через совершенный хеш
+        {
+            const auto* choice = option.FindChoice(value);
+            if (!choice)
+            {
+                auto exception = WrongValue(option, value);
+                auto error = exception.GetError();
+                for (const auto name: option.GetChoiceNames()) // подсказка - допустимые имена
+                    error.suggestions.emplace_back(name);
+                throw ParseException(std::move(error));
+            }
+            out = *choice;
+            return;
+        }
+        int number = 0; // число должно занимать все значение целиком; знак '+' допускается, как и раньше в std::stoi
+        const auto digits = value.size() > 1 && value[0] == '+' && value[1] != '-' ? value.substr(1) : value;
+        const auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), number);
+        if (ec != std::errc{} || end != digits.data() + digits.size())
+            throw ParseException({ParseErrorCode::InvalidValue, option.GetLongOption(),
+                                  "Wrong integer value " + std::string(value), {}});
+        out = number;
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+        out.assign(value.data(), value.size());
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        if (!ParseDouble(value, out))
+            throw WrongValue(option, value);
+    }
+    else if constexpr (std::is_same_v<T, uint64_t>)
+    {
+        if (!ParseByteSize(value, out))
+            throw WrongValue(option, value);
+    }
+    else if constexpr (std::is_same_v<T, std::chrono::nanoseconds>)
+    {
+        if (!ParseDuration(value, out))
+            throw WrongValue(option, value);
+    }
+    else if constexpr (IsValueVector<T>::value)
+    {
+        typename T::value_type item{};
+        ConvertValue(option, value, item);
+        out.push_back(std::move(item));
+    }
+    else
+        static_assert(!std::is_same_v<T, T>, "Unsupported value type");
+}
+
+// Подходит ли тип T (или тип элементов вектора T) для значений опции типа type
+template<typename T>
+bool AcceptsOptionType(OptionType type)
+{
+    if constexpr (IsValueVector<T>::value && !std::is_same_v<T, std::vector<bool>>)
+        return AcceptsOptionType<typename T::value_type>(type);
+    else if constexpr (std::is_same_v<T, bool>)
+        return type == OptionType::FlagOption;
+    else if constexpr (std::is_enum_v<T>)
+        return type == OptionType::EnumOption;
+    else if constexpr (std::is_same_v<T, int>)
+        return type == OptionType::IntegerOption || type == OptionType::EnumOption;
+    else if constexpr (std::is_same_v<T, std::string>)
+        return type == OptionType::StringOption || type == OptionType::PathOption;
+    else if constexpr (std::is_same_v<T, double>)
+        return type == OptionType::DoubleOption;
+    else if constexpr (std::is_same_v<T, uint64_t>)
+        return type == OptionType::SizeOption;
+    else if constexpr (std::is_same_v<T, std::chrono::nanoseconds>)
+        return type == OptionType::DurationOption;
+    else
+        return false;
+}
+
+}
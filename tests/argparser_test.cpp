@@ -1,6 +1,14 @@
 #include <lib/ArgParser.h>
 #include <gtest/gtest.h>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
+#include <unistd.h>
+
+#ifdef ARGPARSER_WITH_ZLIB
+#include <zlib.h>
+#endif
 
 
 using namespace ArgumentParser;
@@ -81,6 +89,10 @@ TEST(ArgParserTestSuite, IntTest) {
 
     ASSERT_TRUE(parser.Parse(SplitString("app --param1=100500")));
     ASSERT_EQ(parser.GetIntValue("param1"), 100500);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --param1=+5")));
+    ASSERT_EQ(parser.GetIntValue("param1"), 5);
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=+-5")));
 }
 
 
@@ -173,3 +185,750 @@ TEST(ArgParserTestSuite, HelpStringTest) {
     //     "-h, --help Display this help and exit\n"
     // );
 }
+
+
+TEST(ArgParserTestSuite, SpillToDiskTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().SpillToDisk(::testing::TempDir(), 2);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app 1 2 3 4 5")));
+    ASSERT_EQ(parser.GetIntValue("Param1", 1), 2);
+    ASSERT_EQ(parser.GetIntValue("Param1", 4), 5);
+
+    int sum = 0;
+    for (int value : parser.GetIntValues("Param1"))
+        sum += value;
+    ASSERT_EQ(sum, 15);
+    ASSERT_EQ(parser.GetIntValues("Param1").size(), 5);
+}
+
+
+TEST(ArgParserTestSuite, EnvTest) {
+    ArgParser parser("My Parser");
+    parser.AddStringArgument("param1").Env("PATH");
+    parser.AddStringArgument("param2").Env("PATH");
+    parser.AddFlag("flag1").Env("PATH");
+    parser.AddIntArgument("param3").Env("ARGPARSER_TEST_UNSET_VARIABLE").Default(3);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --param2=value2")));
+    ASSERT_EQ(parser.GetStringValue("param1"), std::getenv("PATH"));
+    ASSERT_EQ(parser.GetStringValue("param2"), "value2");
+    ASSERT_TRUE(parser.GetFlag("flag1"));
+    ASSERT_EQ(parser.GetIntValue("param3"), 3);
+
+    // повторный разбор снова берет значения из окружения
+    ASSERT_TRUE(parser.Parse(SplitString("app --param2=value2")));
+    ASSERT_TRUE(parser.GetFlag("flag1"));
+    ASSERT_EQ(parser.GetStringValue("param1"), std::getenv("PATH"));
+}
+
+
+TEST(ArgParserTestSuite, ConfigTest) {
+    const std::string path = ::testing::TempDir() + "argparser_config_test.conf";
+    std::ofstream(path) << "# comment\n"
+                           "param1 = value1\n"
+                           "param2=2\n"
+                           "param3=1\n"
+                           "param3=2\n"
+                           "flag1\n";
+
+    ArgParser parser("My Parser");
+    parser.AddStringArgument("param1");
+    parser.AddIntArgument("param2").Env("ARGPARSER_TEST_UNSET_VARIABLE");
+    parser.AddIntArgument("param3").MultiValue(2);
+    parser.AddFlag("flag1");
+    parser.AddIntArgument("param4").Default(4);
+
+    ASSERT_TRUE(parser.LoadConfig(path));
+    ASSERT_TRUE(parser.Parse(SplitString("app --param2=5")));
+    ASSERT_EQ(parser.GetStringValue("param1"), "value1");
+    ASSERT_EQ(parser.GetIntValue("param2"), 5);
+    ASSERT_EQ(parser.GetIntValue("param3", 1), 2);
+    ASSERT_TRUE(parser.GetFlag("flag1"));
+    ASSERT_EQ(parser.GetIntValue("param4"), 4);
+
+    // повторный разбор: те же значения конфигурации, без накопления
+    ASSERT_TRUE(parser.Parse(SplitString("app --param2=5")));
+    ASSERT_TRUE(parser.GetFlag("flag1"));
+    ASSERT_EQ(parser.GetIntValues("param3").size(), 2);
+
+    ArgParser unknown("My Parser");
+    unknown.AddStringArgument("param1");
+    ASSERT_FALSE(unknown.LoadConfig(path));
+
+    // отклоненный файл ничего не меняет, даже если его начало корректно
+    ArgParser rejected("My Parser");
+    rejected.AddStringArgument("param1").Default("default");
+    rejected.AddIntArgument("param2").Default(0);
+    ASSERT_FALSE(rejected.LoadConfig(path));
+    ASSERT_TRUE(rejected.Parse(SplitString("app")));
+    ASSERT_EQ(rejected.GetStringValue("param1"), "default");
+    ASSERT_EQ(rejected.GetIntValue("param2"), 0);
+}
+
+
+TEST(ArgParserTestSuite, SubcommandTest) {
+    ArgParser parser("My Parser");
+    int built = 0;
+    parser.AddHelp('h', "help", "Some Description about program");
+    parser.AddFlag('v', "verbose");
+    parser.AddSubcommand("add", "Add numbers", [&built](ArgParser& sub) {
+        ++built;
+        sub.AddIntArgument("N").MultiValue(1).Positional();
+    });
+    parser.AddSubcommand("remove", [&built](ArgParser& sub) {
+        ++built;
+        sub.AddStringArgument("name");
+    });
+
+    ASSERT_NE(parser.HelpDescription().find("add,  Add numbers"), std::string::npos);
+    ASSERT_EQ(built, 0);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v add 1 2")));
+    ASSERT_EQ(built, 1);
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_EQ(parser.GetSubcommandName(), "add");
+    ASSERT_EQ(parser.GetSubcommand().GetIntValue("N", 1), 2);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -v")));
+    ASSERT_FALSE(parser.HasSubcommand());
+}
+
+
+TEST(ArgParserTestSuite, AbbreviationTest) {
+    ArgParser parser("My Parser");
+    parser.AllowAbbreviations();
+    parser.AddFlag("verbose");
+    parser.AddFlag("version");
+    parser.AddIntArgument("number");
+    parser.AddIntArgument("num").Default(0);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --verb --numb=5 --num=3")));
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_FALSE(parser.GetFlag("version"));
+    ASSERT_EQ(parser.GetIntValue("number"), 5);
+    ASSERT_EQ(parser.GetIntValue("num"), 3);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --ver")));
+
+    ArgParser strict("My Parser");
+    strict.AddFlag("verbose");
+    ASSERT_FALSE(strict.Parse(SplitString("app --verb")));
+}
+
+
+TEST(ArgParserTestSuite, SuggestionTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag("verbose");
+    parser.AddFlag("version");
+    parser.AddIntArgument("number").Default(1);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --verbse")));
+    ASSERT_EQ(parser.GetErrors().size(), 1);
+    const auto& error = parser.GetErrors()[0];
+    ASSERT_EQ(error.code, ParseErrorCode::UnknownOption);
+    ASSERT_EQ(error.option, "verbse");
+    ASSERT_EQ(error.suggestions, std::vector<std::string>({"verbose"}));
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --number=abc")));
+    ASSERT_EQ(parser.GetErrors()[0].code, ParseErrorCode::InvalidValue);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --verbose")));
+    ASSERT_TRUE(parser.GetErrors().empty());
+}
+
+
+TEST(ArgParserTestSuite, ResponseFileTest) {
+    const std::string path = ::testing::TempDir() + "argparser_response_test.txt";
+    std::ofstream(path) << "--param1=value1 -f\n 1 2\t3\n";
+
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    parser.AllowResponseFiles();
+    parser.AddStringArgument("param1");
+    parser.AddFlag('f', "flag1");
+    parser.AddIntArgument("Param2").MultiValue(1).Positional().StoreValues(values);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app @" + path)));
+    ASSERT_EQ(parser.GetStringValue("param1"), "value1");
+    ASSERT_TRUE(parser.GetFlag("flag1"));
+    ASSERT_EQ(values, std::vector<int>({1, 2, 3}));
+}
+
+
+TEST(ArgParserTestSuite, CommandLineTest) {
+    ArgParser parser("My Parser");
+    std::vector<std::string> values;
+    parser.AddStringArgument("param1");
+    parser.AddStringArgument("param2");
+    parser.AddStringArgument("Files").MultiValue().Positional().StoreValues(values);
+
+    ASSERT_TRUE(parser.ParseCommandLine(
+        R"(app --param1="value 1" '--param2=it''s' plain "a\"b" 'single quoted' c\ d "")"));
+    ASSERT_EQ(parser.GetStringValue("param1"), "value 1");
+    ASSERT_EQ(parser.GetStringValue("param2"), "its");
+    ASSERT_EQ(values, std::vector<std::string>({"plain", "a\"b", "single quoted", "c d", ""}));
+
+    ASSERT_FALSE(parser.ParseCommandLine("app --param1='value"));
+}
+
+
+TEST(ArgParserTestSuite, TokenizerTest) {
+    ArgParser parser("My Parser");
+    std::vector<std::string> values;
+    parser.AddStringArgument("Files").MultiValue().Positional().StoreValues(values);
+
+    // пустые аргументы в кавычках, в том числе склеенные (среди позиционных)
+    ASSERT_TRUE(parser.ParseCommandLine(R"(app x '' "" ''"")"));
+    ASSERT_EQ(values, std::vector<std::string>({"x", "", "", ""}));
+
+    // продолжение строки перед аргументом - не аргумент
+    ArgParser continued("My Parser");
+    std::vector<std::string> lines;
+    continued.AddStringArgument("Files").MultiValue().Positional().StoreValues(lines);
+    ASSERT_TRUE(continued.ParseCommandLine("app \\\n a \\\nb"));
+    ASSERT_EQ(lines, std::vector<std::string>({"a", "b"}));
+}
+
+
+TEST(ArgParserTestSuite, ParseCacheTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("param1");
+    parser.AddIntArgument("Param2").MultiValue().Positional();
+    parser.EnableCache(2);
+
+    const auto first = parser.ParseCached(SplitString("app --param1=1 5 6"));
+    const auto second = parser.ParseCached(SplitString("app --param1=2"));
+    const auto again = parser.ParseCached(SplitString("app --param1=1 5 6"));
+
+    ASSERT_EQ(first, again);
+    ASSERT_TRUE(first->Success());
+    ASSERT_EQ(first->GetIntValue("param1"), 1);
+    ASSERT_EQ(first->GetIntValue("Param2", 1), 6);
+    ASSERT_EQ(second->GetIntValue("param1"), 2);
+    ASSERT_EQ(second->GetIntValues("Param2").size(), 0);
+    ASSERT_EQ(parser.GetCacheStats().hits, 1);
+    ASSERT_EQ(parser.GetCacheStats().misses, 2);
+
+    ASSERT_FALSE(parser.ParseCached(SplitString("app"))->Success());
+    ASSERT_THROW(parser.AddFlag("flag1"), std::logic_error);
+}
+
+
+TEST(ArgParserTestSuite, ReparseTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('p', "param1").MultiValue(2);
+    parser.AddFlag('f', "flag1");
+    parser.AddStringArgument("param2").Default("none");
+    parser.AddIntArgument("Values").MultiValue().Positional();
+
+    const auto first = parser.ParseCached(SplitString("app --param1=1 -f 10 20 30"));
+    ASSERT_FALSE(first->Success());
+
+    using Kind = ArgParser::ArgEdit::Kind;
+    const auto second = parser.Reparse(*first, {Kind::Insert, 2, "-p=2"});
+    ASSERT_TRUE(second->Success());
+    ASSERT_EQ(second->GetIntValue("param1", 1), 2);
+    ASSERT_EQ(&second->GetOption("Values"), &first->GetOption("Values"));
+
+    const auto third = parser.Reparse(*second, {Kind::Replace, 5, "25"});
+    ASSERT_EQ(third->GetIntValue("Values", 1), 25);
+    ASSERT_EQ(&third->GetOption("param1"), &second->GetOption("param1"));
+
+    const auto fourth = parser.Reparse(*third, {Kind::Erase, 3, ""});
+    ASSERT_FALSE(fourth->GetFlag("flag1"));
+    ASSERT_EQ(fourth->GetIntValue("Values", 0), 10);
+
+    const auto fifth = parser.Reparse(*fourth, {Kind::Insert, 1, "--param2=value"});
+    ASSERT_EQ(fifth->GetStringValue("param2"), "value");
+    ASSERT_EQ(fifth->GetIntValue("Values", 2), 30);
+
+    const auto full = parser.ParseCached(SplitString("app --param2=value --param1=1 -p=2 10 25 30"));
+    ASSERT_EQ(fifth->GetIntValues("Values").size(), full->GetIntValues("Values").size());
+    ASSERT_EQ(fifth->GetIntValue("param1", 0), full->GetIntValue("param1", 0));
+
+    const auto structural = parser.Reparse(*fifth, {Kind::Insert, 1, "5"});
+    ASSERT_FALSE(structural->Success());
+}
+
+
+TEST(ArgParserTestSuite, ConstraintTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag("sum");
+    parser.AddFlag("mult");
+    parser.AddStringArgument("user").Default("");
+    parser.AddStringArgument("password").Default("");
+    parser.AddStringArgument("output").Default("");
+    parser.AddStringArgument("format").Default("");
+    parser.MutuallyExclusive({"sum", "mult"});
+    parser.AtLeastOneOf({"sum", "mult"});
+    parser.Requires("user", {"password"});
+    parser.Requires("output", {"format"});
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --sum --user=u --password=p")));
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --sum --mult --user=u --output=o")));
+    const auto& errors = parser.GetErrors();
+    ASSERT_EQ(errors.size(), 3);
+    ASSERT_EQ(errors[0].code, ParseErrorCode::ConstraintViolation);
+    ASSERT_EQ(errors[0].message, "Options sum, mult are mutually exclusive");
+    ASSERT_EQ(errors[1].message, "Option user requires password");
+    ASSERT_EQ(errors[2].option, "output");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetErrors().size(), 1);
+    ASSERT_EQ(parser.GetErrors()[0].message, "One of options sum, mult is required");
+    ASSERT_THROW(parser.Requires("user", {"unknown"}), std::logic_error);
+}
+
+
+TEST(ArgParserTestSuite, FlagBitsetTest) {
+    ArgParser parser("My Parser");
+    bool stored = false;
+    parser.AddFlag('a', "flag1").StoreValue(stored);
+    parser.AddFlag('b', "flag2").Default(true);
+    parser.AddFlag('c', "flag3");
+    parser.AddIntArgument('i', "param1").Default(0);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -ac")));
+    const auto& flags = parser.FlagsBitset();
+    ASSERT_TRUE(flags.Test(parser.FlagId("flag1")));
+    ASSERT_TRUE(flags.Test(parser.FlagId("flag2")));
+    ASSERT_TRUE(flags.Test(parser.FlagId("flag3")));
+    ASSERT_TRUE(stored);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -bi=5")));
+    ASSERT_FALSE(parser.GetFlag("flag1"));
+    ASSERT_TRUE(parser.GetFlag("flag2"));
+    ASSERT_EQ(parser.GetIntValue("param1"), 5);
+    ASSERT_FALSE(parser.Parse(SplitString("app -ai")));
+    ASSERT_THROW(parser.FlagId("param1"), std::logic_error);
+
+    parser.Freeze();
+    const auto result = parser.ParseCached(SplitString("app --flag3"));
+    ASSERT_TRUE(result->GetFlag("flag3"));
+    ASSERT_FALSE(result->FlagsBitset().Test(parser.FlagId("flag1")));
+}
+
+
+TEST(ArgParserTestSuite, EnumTest) {
+    enum class Codec { None, Gzip, Zstd };
+    ArgParser parser("My Parser");
+    parser.AddEnumArgument<Codec>('c', "codec", "compression",
+                                  {{"none", Codec::None}, {"gzip", Codec::Gzip}, {"zstd", Codec::Zstd}})
+        .Default(Codec::None);
+    parser.AddEnumArgument<Codec>("extra", {{"gzip", Codec::Gzip}, {"zstd", Codec::Zstd}}).MultiValue();
+    parser.AddHelp('h', "help", "Some Description about program");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --extra=zstd --extra=gzip")));
+    ASSERT_EQ(parser.GetEnumValue<Codec>("codec"), Codec::None);
+    ASSERT_EQ(parser.GetEnumValue<Codec>("extra", 0), Codec::Zstd);
+    ASSERT_EQ(parser.GetEnumValue<Codec>("extra", 1), Codec::Gzip);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -c=gzip")));
+    ASSERT_EQ(parser.GetEnumValue<Codec>("codec"), Codec::Gzip);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --codec=lz4")));
+    ASSERT_EQ(parser.GetErrors()[0].code, ParseErrorCode::InvalidValue);
+    ASSERT_EQ(parser.GetErrors()[0].suggestions, std::vector<std::string>({"none", "gzip", "zstd"}));
+    ASSERT_NE(parser.HelpDescription().find("[none|gzip|zstd][default = none]"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, UnitsTest) {
+    using namespace std::chrono_literals;
+    ArgParser parser("My Parser");
+    uint64_t cache = 0;
+    parser.AddDoubleArgument('r', "ratio").Default(0.5);
+    parser.AddSizeArgument("cache").Default(64 * 1024).StoreValue(cache);
+    parser.AddSizeArgument("limit").MultiValue();
+    parser.AddDurationArgument("timeout", "request timeout").Default(90min);
+    parser.AddHelp('h', "help", "Some Description about program");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --limit=1.5G --limit=2GiB --limit=10KB --limit=512")));
+    ASSERT_DOUBLE_EQ(parser.GetDoubleValue("ratio"), 0.5);
+    ASSERT_EQ(parser.GetSizeValue("cache"), 65536);
+    ASSERT_EQ(parser.GetSizeValue("limit", 0), 1610612736);
+    ASSERT_EQ(parser.GetSizeValue("limit", 1), 2147483648);
+    ASSERT_EQ(parser.GetSizeValue("limit", 2), 10000);
+    ASSERT_EQ(parser.GetSizeValue("limit", 3), 512);
+    ASSERT_EQ(parser.GetDurationValue("timeout"), 90min);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -r=1e-3 --cache=8M --timeout=1h30m250ms")));
+    ASSERT_DOUBLE_EQ(parser.GetDoubleValue("ratio"), 0.001);
+    ASSERT_EQ(cache, 8 * 1024 * 1024);
+    ASSERT_EQ(parser.GetDurationValue("timeout"), 1h + 30min + 250ms);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --cache=8X")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --timeout=5")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --timeout=")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --ratio=0.5x")));
+    const auto help = parser.HelpDescription();
+    ASSERT_NE(help.find("[default = 64K]"), std::string::npos);
+    ASSERT_NE(help.find("request timeout[default = 1h30m]"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, RangesTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("ids").MultiValue(1).Ranges();
+    parser.AddIntArgument("shards").MultiValue().Ranges();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --ids=1,5,9-100000 --ids=-3--1 --shards=0-999999")));
+    const auto ids = parser.GetIntValues("ids");
+    ASSERT_EQ(ids.size(), 2 + 99992 + 3);
+    ASSERT_EQ(parser.GetIntValue("ids", 1), 5);
+    ASSERT_EQ(parser.GetIntValue("ids", 2), 9);
+    ASSERT_EQ(parser.GetIntValue("ids", 99993), 100000);
+    ASSERT_EQ(parser.GetIntValue("ids", 99994), -3);
+    ASSERT_EQ(std::vector<int>(ids.begin(), std::next(ids.begin(), 4)), std::vector<int>({1, 5, 9, 10}));
+    const std::vector<int> walked(ids.begin(), ids.end()); // обход переходит через границы отрезков
+    ASSERT_EQ(walked.size(), ids.size());
+    ASSERT_EQ(walked[99993], 100000);
+    ASSERT_EQ(walked[99994], -3);
+    ASSERT_EQ(walked.back(), -1);
+    ASSERT_EQ(parser.GetIntValues("shards").size(), 1000000);
+    ASSERT_EQ(parser.GetIntValue("shards", 654321), 654321);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --ids=5-1")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --ids=1,,2")));
+    std::vector<int> values;
+    ASSERT_THROW(parser.AddIntArgument("other").MultiValue().Ranges().StoreValues(values), std::logic_error);
+}
+
+
+TEST(ArgParserTestSuite, SeparatorTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> int_values;
+    parser.AddIntArgument('p', "param1").MultiValue(3).Separator().StoreValues(int_values);
+    parser.AddStringArgument("names").MultiValue().Separator(':');
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --param1=1,2,3 --names=a:b")));
+    ASSERT_EQ(int_values, std::vector<int>({1, 2, 3}));
+    ASSERT_EQ(parser.GetStringValue("names", 1), "b");
+
+    int_values.clear();
+    ASSERT_TRUE(parser.Parse(SplitString("app -p=4,5 -p=6,7,8,9,10,11,12,13,14,15,16,17,18,19,20")));
+    ASSERT_EQ(int_values.size(), 17);
+    ASSERT_EQ(int_values[16], 20);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=1,,2")));
+    ASSERT_THROW(parser.AddIntArgument("single").Separator(), std::logic_error);
+}
+
+
+TEST(ArgParserTestSuite, ActionTest) {
+    ArgParser parser("My Parser");
+    std::vector<std::string> events;
+    parser.AddFlag('v', "verbose").Action([&events](bool value) {
+        events.push_back(value ? "verbose" : "quiet");
+    });
+    parser.AddIntArgument('j', "jobs").Default(1).Action([&events](int jobs) {
+        events.push_back("jobs " + std::to_string(jobs));
+    });
+    parser.AddStringArgument("name").Default("").Action([&events](const std::string& name) {
+        events.push_back("name " + name);
+    });
+    parser.OnUnknownOption([&events](std::string_view arg) {
+        events.emplace_back(arg);
+        return arg.substr(0, 4) == "--x-";
+    });
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --jobs=4 --x-trace -v --name=abc")));
+    ASSERT_EQ(events, std::vector<std::string>({"jobs 4", "--x-trace", "verbose", "name abc"}));
+
+    events.clear();
+    ASSERT_FALSE(parser.Parse(SplitString("app --unknown")));
+    ASSERT_EQ(events, std::vector<std::string>({"--unknown"}));
+    ASSERT_EQ(parser.GetErrors()[0].code, ParseErrorCode::UnknownOption);
+    ASSERT_THROW(parser.AddIntArgument("other").Action([](const std::string&) {}), std::logic_error);
+}
+
+
+TEST(ArgParserTestSuite, BindTest) {
+    struct Settings {
+        bool verbose = false;
+        int jobs = 1;
+        std::string name;
+        std::vector<int> values;
+        uint64_t cache = 0;
+    };
+    ArgParser parser("My Parser");
+    parser.AddFlag('v', "verbose");
+    parser.AddIntArgument('j', "jobs").Default(1);
+    parser.AddStringArgument("name");
+    parser.AddSizeArgument("cache").Default(0);
+    parser.AddIntArgument("Values").MultiValue(2).Positional();
+    parser.Bind(&Settings::verbose, "verbose")
+          .Bind(&Settings::jobs, "jobs")
+          .Bind(&Settings::name, "name")
+          .Bind(&Settings::cache, "cache")
+          .Bind(&Settings::values, "Values");
+
+    Settings settings;
+    ASSERT_TRUE(parser.ParseInto(settings, SplitString("app -vj=4 --name=abc --cache=1K 10 20 30")));
+    ASSERT_TRUE(settings.verbose);
+    ASSERT_EQ(settings.jobs, 4);
+    ASSERT_EQ(settings.name, "abc");
+    ASSERT_EQ(settings.cache, 1024);
+    ASSERT_EQ(settings.values, std::vector<int>({10, 20, 30}));
+
+    Settings missing;
+    ASSERT_FALSE(parser.ParseInto(missing, SplitString("app 10")));
+    ASSERT_EQ(parser.GetErrors().size(), 2);
+    ASSERT_EQ(parser.GetErrors()[0].option, "name");
+    ASSERT_EQ(parser.GetErrors()[1].option, "Values");
+
+    struct Other { int jobs = 0; };
+    ASSERT_THROW(parser.Bind(&Other::jobs, "jobs"), std::logic_error);
+    ASSERT_THROW(parser.Bind(&Settings::name, "jobs"), std::logic_error);
+}
+
+
+struct Endpoint {
+    std::string host;
+    int port = 0;
+};
+
+std::errc ParseEndpoint(std::string_view text, Endpoint& endpoint) {
+    const auto colon = text.rfind(':');
+    if (colon == std::string_view::npos || colon == 0)
+        return std::errc::invalid_argument;
+    const auto [end, ec] = std::from_chars(text.data() + colon + 1, text.data() + text.size(), endpoint.port);
+    if (ec != std::errc{} || end != text.data() + text.size())
+        return std::errc::result_out_of_range;
+    endpoint.host = std::string(text.substr(0, colon));
+    return {};
+}
+
+TEST(ArgParserTestSuite, CustomConverterTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<Endpoint>("listen").Default(Endpoint{"localhost", 80}).Converter(ParseEndpoint);
+    parser.AddArgument<Endpoint>('u', "upstream", "Upstreams").Converter(ParseEndpoint).MultiValue(1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -u=a:1 --upstream=b:2")));
+    ASSERT_EQ(parser.GetValue<Endpoint>("listen").port, 80);
+    ASSERT_EQ(parser.GetValue<Endpoint>("upstream", 1).host, "b");
+    ASSERT_EQ(parser.GetValue<Endpoint>("upstream", 1).port, 2);
+    ASSERT_THROW(parser.GetValue<int>("listen"), std::logic_error);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --listen=0.0.0.0:8080 -u=a:1")));
+    ASSERT_EQ(parser.GetValue<Endpoint>("listen").host, "0.0.0.0");
+    ASSERT_EQ(parser.GetValue<Endpoint>("listen").port, 8080);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --listen=nowhere -u=a:1")));
+    ASSERT_EQ(parser.GetErrors().size(), 1);
+    ASSERT_EQ(parser.GetErrors()[0].code, ParseErrorCode::InvalidValue);
+    ASSERT_EQ(parser.GetErrors()[0].option, "listen");
+}
+
+
+TEST(ArgParserTestSuite, PathTest) {
+    const std::string path = ::testing::TempDir() + "argparser_path_test.txt";
+    const std::string missing = ::testing::TempDir() + "argparser_path_missing.txt";
+    std::ofstream(path) << "data\n";
+
+    ArgParser parser("My Parser");
+    parser.AddPathArgument('i', "input", "Inputs").MustExist().MustBeReadable().MultiValue(1);
+    parser.AddPathArgument("output").Default("out.txt");
+
+    std::vector<std::string> args = {"app"};
+    for (int i = 0; i < 100; ++i) // несколько пакетов проверок
+        args.push_back("--input=" + path);
+    ASSERT_TRUE(parser.Parse(args));
+    ASSERT_EQ(parser.GetStringValue("input", 99), path);
+    ASSERT_EQ(parser.GetStringValue("output"), "out.txt");
+
+    args[40] = "--input=" + missing;
+    args.push_back("-i=" + missing);
+    ASSERT_FALSE(parser.Parse(args));
+    ASSERT_EQ(parser.GetErrors().size(), 2);
+    ASSERT_EQ(parser.GetErrors()[0].code, ParseErrorCode::InvalidPath);
+    ASSERT_EQ(parser.GetErrors()[0].option, "input");
+    ASSERT_NE(parser.GetErrors()[1].message.find(missing), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, PrefetchTest) {
+    const std::string path = ::testing::TempDir() + "argparser_prefetch_test.txt";
+    std::ofstream(path) << "prefetched\n";
+
+    ArgParser parser("My Parser");
+    parser.AddPathArgument("input").MultiValue(1).Prefetch();
+    parser.AddPathArgument("plain").Default("");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --input=" + path + " --input=" + path + ".missing")));
+    const int fd = parser.GetFileDescriptor("input", 0);
+    ASSERT_GE(fd, 0);
+    char content[10] = {};
+    ASSERT_EQ(::read(fd, content, sizeof(content)), sizeof(content));
+    ASSERT_EQ(std::string(content, sizeof(content)), "prefetched");
+    ASSERT_EQ(parser.GetFileDescriptor("input", 1), -1);
+    ASSERT_THROW(parser.GetFileDescriptor("plain"), std::logic_error);
+}
+
+
+TEST(ArgParserTestSuite, GlobTest) {
+    const std::string root = ::testing::TempDir() + "argparser_glob_test";
+    std::filesystem::remove_all(root);
+    for (const char* dir: {"2026-01", "2026-02", "2025-12"}) {
+        std::filesystem::create_directories(root + "/" + dir);
+        for (const char* file: {"part-2.bin", "part-1.bin", "part-1.txt", ".part-3.bin"})
+            std::ofstream(root + "/" + dir + "/" + file) << "x";
+    }
+
+    ArgParser parser("My Parser");
+    parser.AddPathArgument("inputs").MultiValue(1).Positional().Glob(4);
+    ASSERT_TRUE(parser.Parse(SplitString("app " + root + "/2026-*/part-?.bin " + root + "/none-*")));
+    ASSERT_EQ(parser.GetStringValue("inputs", 0), root + "/2026-01/part-1.bin");
+    ASSERT_EQ(parser.GetStringValue("inputs", 1), root + "/2026-01/part-2.bin");
+    ASSERT_EQ(parser.GetStringValue("inputs", 3), root + "/2026-02/part-2.bin");
+    ASSERT_EQ(parser.GetStringValue("inputs", 4), root + "/none-*"); // без совпадений - как есть
+
+    ArgParser limited("My Parser");
+    limited.AddPathArgument("inputs").MultiValue(1).Positional().Glob(4);
+    ASSERT_FALSE(limited.Parse(SplitString("app " + root + "/*/part-[0-9].*")));
+    ASSERT_EQ(limited.GetErrors()[0].code, ParseErrorCode::InvalidValue);
+
+    // правка аргумента с шаблоном разворачивается так же, как при полном разборе
+    ArgParser cached("My Parser");
+    cached.AddPathArgument("in").MultiValue().Glob(10);
+    const auto first = cached.ParseCached({"app", "--in=" + root + "/2026-01/part-?.bin"});
+    ASSERT_EQ(first->GetStringValue("in", 1), root + "/2026-01/part-2.bin");
+    const auto edited = cached.Reparse(*first, {ArgParser::ArgEdit::Kind::Replace, 1, "--in=" + root + "/2026-02/part-2*"});
+    ASSERT_EQ(edited->GetStringValue("in", 0), root + "/2026-02/part-2.bin");
+}
+
+
+TEST(ArgParserTestSuite, ParallelResponseFileTest) {
+    const std::string path = ::testing::TempDir() + "argparser_parallel_response_test.txt";
+    const std::string bad = ::testing::TempDir() + "argparser_parallel_response_bad.txt";
+    {
+        std::ofstream file(path);
+        std::ofstream badFile(bad);
+        for (int i = 0; i < 2000; ++i) {
+            file << "--number=" << i << " -s=v" << i << (i % 7 ? " " : "\n");
+            badFile << "--number=" << (i == 1500 ? "x" : std::to_string(i)) << ' ';
+        }
+        file << "first 2nd --number=-1";
+    }
+
+    const auto makeParser = [](size_t shardBytes) {
+        auto parser = std::make_unique<ArgParser>("My Parser");
+        parser->AllowResponseFiles();
+        if (shardBytes)
+            parser->ParallelResponseFiles(shardBytes);
+        parser->AddIntArgument("number").MultiValue(1);
+        parser->AddStringArgument('s', "string");
+        parser->AddStringArgument("rest").MultiValue().Positional();
+        return parser;
+    };
+    const auto serial = makeParser(0);
+    const auto parallel = makeParser(256);
+
+    ASSERT_TRUE(serial->Parse(SplitString("app @" + path)));
+    ASSERT_TRUE(parallel->Parse(SplitString("app @" + path)));
+    ASSERT_EQ(parallel->GetIntValue("number", 1999), 1999);
+    ASSERT_EQ(parallel->GetStringValue("string"), "v1999"); // одиночная опция - последнее значение
+    ASSERT_EQ(parallel->GetStringValue("rest", 2), "--number=-1"); // после позиционного - все позиционные
+    for (int i = 0; i < 2000; i += 97)
+        ASSERT_EQ(parallel->GetIntValue("number", i), serial->GetIntValue("number", i));
+
+    ASSERT_FALSE(parallel->Parse(SplitString("app @" + bad)));
+    ASSERT_EQ(parallel->GetErrors().size(), 1);
+    ASSERT_EQ(parallel->GetErrors()[0].message, "Wrong integer value x");
+}
+
+
+TEST(ArgParserTestSuite, CompressedResponseFileTest) {
+#ifndef ARGPARSER_WITH_ZLIB
+    GTEST_SKIP() << "zlib is not available";
+#else
+    const std::string path = ::testing::TempDir() + "argparser_compressed_test.txt.gz";
+    gzFile file = gzopen(path.c_str(), "wb");
+    for (int i = 0; i < 30000; ++i) { // текст больше буфера распаковки: аргументы попадают на границы фрагментов
+        const auto token = "--number=" + std::to_string(i) + (i % 5 ? " " : "\n");
+        gzwrite(file, token.data(), static_cast<unsigned>(token.size()));
+    }
+    gzputs(file, "-s=last");
+    gzclose(file);
+
+    ArgParser parser("My Parser");
+    parser.AllowResponseFiles();
+    parser.AddIntArgument("number").MultiValue(1);
+    parser.AddStringArgument('s', "string");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app @" + path)));
+    int expected = 0;
+    for (const int value: parser.GetIntValues("number"))
+        ASSERT_EQ(value, expected++);
+    ASSERT_EQ(expected, 30000);
+    ASSERT_EQ(parser.GetStringValue("string"), "last");
+#endif
+}
+
+
+TEST(ArgParserTestSuite, BinaryArgsTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number").MultiValue(1);
+    parser.AddFlag('f', "flag");
+    parser.AddStringArgument('s', "string");
+    parser.AddDoubleArgument("ratio").Default(0.5);
+
+    BinaryArgsWriter writer;
+    writer.Add(parser.OptionId("number"), 1);
+    writer.Add(parser.OptionId("number"), -2);
+    writer.Add("flag", true);
+    writer.Add("string", "a b,c"); // значение не разделяется и не разбирается
+    writer.Add(parser.OptionId("number"), 3);
+
+    ASSERT_TRUE(parser.ParseBinary(writer.Data()));
+    ASSERT_EQ(parser.GetIntValue("number", 0), 1);
+    ASSERT_EQ(parser.GetIntValue("number", 1), -2);
+    ASSERT_EQ(parser.GetIntValue("number", 2), 3);
+    ASSERT_TRUE(parser.GetFlag("flag"));
+    ASSERT_EQ(parser.GetStringValue("string"), "a b,c");
+    ASSERT_EQ(parser.GetDoubleValue("ratio"), 0.5);
+
+    BinaryArgsWriter unknown;
+    unknown.Add("missing", 1);
+    ASSERT_FALSE(parser.ParseBinary(unknown.Data()));
+    ASSERT_EQ(parser.GetErrors().front().code, ParseErrorCode::UnknownOption);
+
+    auto truncated = writer.Data();
+    truncated.pop_back();
+    ASSERT_FALSE(parser.ParseBinary(truncated));
+    ASSERT_EQ(parser.GetErrors().front().code, ParseErrorCode::InvalidArgument);
+}
+
+
+TEST(ArgParserTestSuite, ModifierAfterParseTest) {
+    ArgParser parser("My Parser");
+    auto& flag = parser.AddFlag("flag");
+    auto& text = parser.AddStringArgument("text");
+    auto& numbers = parser.AddIntArgument("numbers").MultiValue();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --text=a")));
+    ASSERT_FALSE(parser.GetFlag("flag"));
+
+    // настройки опций, измененные между разборами, действуют со следующего разбора
+    flag.Default(true);
+    text.Default("b");
+    numbers.MultiValue(2);
+    ASSERT_FALSE(parser.Parse(SplitString("app --numbers=1")));
+    ASSERT_EQ(parser.GetErrors().front().code, ParseErrorCode::MissingValue);
+    ASSERT_TRUE(parser.Parse(SplitString("app --numbers=1 --numbers=2")));
+    ASSERT_TRUE(parser.GetFlag("flag"));
+
+    // хранилище и действие флага, добавленные после разбора, срабатывают и для длинного имени, и в кластере
+    auto& first = parser.AddFlag('a', "first");
+    auto& second = parser.AddFlag('b', "second");
+    ASSERT_TRUE(parser.Parse(SplitString("app -ab")));
+    bool stored = false;
+    int calls = 0;
+    first.StoreValue(stored);
+    second.Action([&calls](bool) { ++calls; });
+    ASSERT_TRUE(parser.Parse(SplitString("app --first -b")));
+    ASSERT_TRUE(stored);
+    ASSERT_EQ(calls, 1);
+}